@@ -0,0 +1,152 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "AllocationTracker.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+
+#include <malloc.h>
+
+namespace Charging {
+
+namespace {
+
+std::atomic<bool> tracking {false};
+std::atomic<uint64_t> allocations {0};
+std::atomic<uint64_t> allocatedBytes {0};
+std::atomic<int64_t> liveBytes {0};
+std::atomic<int64_t> peakBytes {0};
+
+void raiseTo ( int64_t live ) noexcept {
+    int64_t peak = peakBytes.load ( std::memory_order_relaxed );
+    while ( live > peak and not peakBytes.compare_exchange_weak ( peak, live, std::memory_order_relaxed ) ) {
+    }
+}
+
+void counted ( void* pointer ) noexcept {
+    const auto size = static_cast<int64_t> ( malloc_usable_size ( pointer ) );
+    allocations.fetch_add ( 1, std::memory_order_relaxed );
+    allocatedBytes.fetch_add ( static_cast<uint64_t> ( size ), std::memory_order_relaxed );
+    raiseTo ( liveBytes.fetch_add ( size, std::memory_order_relaxed ) + size );
+}
+
+/**
+ * @brief What every operator new does: malloc, or aligned_alloc for over-aligned types, calling
+ * the new_handler until it succeeds.
+ *
+ * @return nullptr if it doesn't, and there's no new_handler
+ */
+void* allocate ( std::size_t size, std::size_t alignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__ ) {
+    if ( size == 0 )
+        size = 1;
+    for ( ;; ) {
+        void* pointer = ( alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__ )
+                        ? std::malloc ( size )
+                        : std::aligned_alloc ( alignment, ( size + alignment - 1 ) / alignment * alignment ); //a multiple of alignment
+        if ( pointer != nullptr ) {
+            if ( tracking.load ( std::memory_order_relaxed ) )
+                counted ( pointer );
+            return pointer;
+        }
+        const std::new_handler handler = std::get_new_handler();
+        if ( handler == nullptr )
+            return nullptr;
+        handler();
+    }
+}
+
+void* allocateOrThrow ( std::size_t size, std::size_t alignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__ ) {
+    void* pointer = allocate ( size, alignment );
+    if ( pointer == nullptr )
+        throw std::bad_alloc();
+    return pointer;
+}
+
+void* allocateOrNull ( std::size_t size, std::size_t alignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__ ) noexcept {
+    try {
+        return allocate ( size, alignment );
+    } catch ( ... ) { //the new_handler may throw
+        return nullptr;
+    }
+}
+
+void release ( void* pointer ) noexcept {
+    if ( pointer == nullptr )
+        return;
+    if ( tracking.load ( std::memory_order_relaxed ) )
+        liveBytes.fetch_sub ( static_cast<int64_t> ( malloc_usable_size ( pointer ) ), std::memory_order_relaxed );
+    std::free ( pointer );
+}
+
+} //namespace
+
+AllocationTracker::AllocationTracker() {
+    if ( tracking.exchange ( true ) )
+        throw std::logic_error ( "An allocation tracker is already running" );
+    //anything allocated between the exchange and here is zeroed away
+    allocations.store ( 0 );
+    allocatedBytes.store ( 0 );
+    liveBytes.store ( 0 );
+    peakBytes.store ( 0 );
+}
+
+AllocationTracker::~AllocationTracker() {
+    tracking.store ( false );
+}
+
+bool AllocationTracker::isTracking() noexcept {
+    return tracking.load ( std::memory_order_relaxed );
+}
+
+AllocationTracker::Counters AllocationTracker::getCounters() noexcept {
+    return {allocations.load ( std::memory_order_relaxed ), allocatedBytes.load ( std::memory_order_relaxed ),
+            liveBytes.load ( std::memory_order_relaxed )};
+}
+
+int64_t AllocationTracker::getPeak() noexcept {
+    return peakBytes.load ( std::memory_order_relaxed );
+}
+
+int64_t AllocationTracker::restartPeak() noexcept {
+    return peakBytes.exchange ( liveBytes.load ( std::memory_order_relaxed ), std::memory_order_relaxed );
+}
+
+void AllocationTracker::raisePeak ( int64_t peak ) noexcept {
+    raiseTo ( peak );
+}
+
+} //namespace Charging
+
+//Every replaceable global allocation function. See AllocationTracker.
+using Charging::allocateOrThrow;
+using Charging::allocateOrNull;
+using Charging::release;
+
+void* operator new ( std::size_t size ) { return allocateOrThrow ( size ); }
+void* operator new[] ( std::size_t size ) { return allocateOrThrow ( size ); }
+void* operator new ( std::size_t size, const std::nothrow_t& ) noexcept { return allocateOrNull ( size ); }
+void* operator new[] ( std::size_t size, const std::nothrow_t& ) noexcept { return allocateOrNull ( size ); }
+void* operator new ( std::size_t size, std::align_val_t alignment ) { return allocateOrThrow ( size, static_cast<std::size_t> ( alignment ) ); }
+void* operator new[] ( std::size_t size, std::align_val_t alignment ) { return allocateOrThrow ( size, static_cast<std::size_t> ( alignment ) ); }
+void* operator new ( std::size_t size, std::align_val_t alignment, const std::nothrow_t& ) noexcept {
+    return allocateOrNull ( size, static_cast<std::size_t> ( alignment ) );
+}
+void* operator new[] ( std::size_t size, std::align_val_t alignment, const std::nothrow_t& ) noexcept {
+    return allocateOrNull ( size, static_cast<std::size_t> ( alignment ) );
+}
+
+void operator delete ( void* pointer ) noexcept { release ( pointer ); }
+void operator delete[] ( void* pointer ) noexcept { release ( pointer ); }
+void operator delete ( void* pointer, std::size_t ) noexcept { release ( pointer ); }
+void operator delete[] ( void* pointer, std::size_t ) noexcept { release ( pointer ); }
+void operator delete ( void* pointer, const std::nothrow_t& ) noexcept { release ( pointer ); }
+void operator delete[] ( void* pointer, const std::nothrow_t& ) noexcept { release ( pointer ); }
+void operator delete ( void* pointer, std::align_val_t ) noexcept { release ( pointer ); }
+void operator delete[] ( void* pointer, std::align_val_t ) noexcept { release ( pointer ); }
+void operator delete ( void* pointer, std::size_t, std::align_val_t ) noexcept { release ( pointer ); }
+void operator delete[] ( void* pointer, std::size_t, std::align_val_t ) noexcept { release ( pointer ); }
+void operator delete ( void* pointer, std::align_val_t, const std::nothrow_t& ) noexcept { release ( pointer ); }
+void operator delete[] ( void* pointer, std::align_val_t, const std::nothrow_t& ) noexcept { release ( pointer ); }
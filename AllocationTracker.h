@@ -0,0 +1,93 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+#ifndef ALLOCATIONTRACKER_H
+#define ALLOCATIONTRACKER_H
+
+#include <cstdint>
+
+namespace Charging {
+
+/**
+ * @brief Counts heap allocations, for as long as it exists. One at a time.
+ *
+ * Global operator new and operator delete, every form of them, are replaced (in
+ * AllocationTracker.cpp) with ones which go to malloc and free, and which count while there's an
+ * AllocationTracker: the number of allocations, the bytes allocated, and the bytes live, i.e.
+ * allocated less freed, and the peak of that. Sizes are what the allocator gave,
+ * malloc_usable_size(), a little over what was asked.
+ *
+ * RunStats::Scope reads the counters, so with an AllocationTracker every phase of --stats gets
+ * its allocations too:
+ *
+ *      AllocationTracker tracker;
+ *      RunStats stats;
+ *      ChargingNetwork cn {path, ChargingNetwork::IngestionEngine::MAPPED, 1,
+ *                          ChargingNetwork::EventCoalescing::NONE, &stats};
+ *
+ * Without one an allocation costs a relaxed load of a flag more than it would. With one, every
+ * allocation and free also updates shared atomics, which threads allocating at once contend on,
+ * so times taken while tracking run slower.
+ *
+ * Live bytes only count what's allocated and freed while tracking. Freeing memory allocated before
+ * takes them down, even below 0.
+ */
+class AllocationTracker
+{
+public:
+    struct Counters {
+        uint64_t allocations {0};
+        uint64_t bytes {0};         ///< allocated, not taking off what was freed
+        int64_t liveBytes {0};      ///< allocated less freed
+    };
+
+    /**
+     * @brief Constructor. Zeroes the counters and starts counting.
+     * Throws std::logic_error if there's already an AllocationTracker.
+     */
+    AllocationTracker();
+
+    /**
+     * Destructor. Stops counting.
+     */
+    ~AllocationTracker();
+
+    AllocationTracker ( const AllocationTracker& other ) = delete;
+    AllocationTracker& operator= ( const AllocationTracker& other ) = delete;
+
+    /**
+     * @brief Whether allocations are being counted, i.e. there's an AllocationTracker.
+     */
+    static bool isTracking() noexcept;
+
+    /**
+     * @brief The counters as they are now.
+     *
+     * @return Counters
+     */
+    static Counters getCounters() noexcept;
+
+    /**
+     * @brief The peak of live bytes since tracking started, or the last restartPeak().
+     *
+     * @return int64_t
+     */
+    static int64_t getPeak() noexcept;
+
+    /**
+     * @brief Start measuring the peak again, from the live bytes now.
+     *
+     * @return int64_t the peak until now, so that it can be put back with raisePeak()
+     */
+    static int64_t restartPeak() noexcept;
+
+    /**
+     * @brief Make the peak at least this.
+     */
+    static void raisePeak ( int64_t peak ) noexcept;
+};
+
+} //namespace Charging
+
+#endif // ALLOCATIONTRACKER_H
@@ -20,7 +20,6 @@ AvailabilityEvent::AvailabilityEvent (  nanoseconds_t startTime, nanoseconds_t e
 
 
 AvailabilityEvent::~AvailabilityEvent() { // = default
-     Debug( "~AvailabilityEvent()\n" );
 }
 
 AvailabilityEvent& AvailabilityEvent::operator= ( const AvailabilityEvent& other ) = default;
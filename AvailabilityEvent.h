@@ -5,9 +5,10 @@
 #ifndef AVAILABILITYEVENT_H
 #define AVAILABILITYEVENT_H
 
-#include "Charger.h"
-
+#include <compare>
+#include <cstdint>
 #include <memory>
+#include <ostream>
 #include <vector>
 
 namespace Availability {
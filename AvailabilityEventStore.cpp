@@ -0,0 +1,135 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "AvailabilityEventStore.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace Availability {
+
+AvailabilityEventStore::AvailabilityEventStore() = default;
+
+AvailabilityEventStore::AvailabilityEventStore ( std::pmr::memory_resource* resource ) :
+    starts {resource}, ends {resource}, availableBits {resource} {
+}
+
+AvailabilityEventStore::AvailabilityEventStore ( const AvailabilityEventStore& other ) :
+    starts {other.starts}, ends {other.ends}, availableBits {other.availableBits}, count {other.count},
+    startView {other.startView}, endView {other.endView}, bitView {other.bitView}, backing {other.backing} {
+    //the views of an owned store have to point at our own copies
+    if ( not this->backing )
+        this->rebind();
+}
+
+AvailabilityEventStore::AvailabilityEventStore ( AvailabilityEventStore&& other ) noexcept :
+    starts {std::move ( other.starts )}, ends {std::move ( other.ends )}, availableBits {std::move ( other.availableBits )},
+    count {std::exchange ( other.count, 0 )}, startView {other.startView}, endView {other.endView}, bitView {other.bitView},
+    backing {std::move ( other.backing )} {
+    if ( not this->backing )
+        this->rebind();
+    other.rebind();
+}
+
+AvailabilityEventStore::~AvailabilityEventStore() = default;
+
+AvailabilityEventStore& AvailabilityEventStore::operator= ( const AvailabilityEventStore& other ) {
+    if ( this != &other ) {
+        AvailabilityEventStore copy {other};
+        *this = std::move ( copy );
+    }
+    return *this;
+}
+
+AvailabilityEventStore& AvailabilityEventStore::operator= ( AvailabilityEventStore&& other ) noexcept {
+    if ( this != &other ) {
+        this->starts = std::move ( other.starts );
+        this->ends = std::move ( other.ends );
+        this->availableBits = std::move ( other.availableBits );
+        this->count = std::exchange ( other.count, 0 );
+        this->startView = other.startView;
+        this->endView = other.endView;
+        this->bitView = other.bitView;
+        this->backing = std::move ( other.backing );
+        if ( not this->backing )
+            this->rebind();
+        other.clear();
+    }
+    return *this;
+}
+
+AvailabilityEventStore AvailabilityEventStore::borrow ( std::span<const nanoseconds_t> startTimes, std::span<const nanoseconds_t> endTimes,
+                                                        std::span<const uint64_t> availableWords, std::shared_ptr<const void> backing ) {
+    AvailabilityEventStore store;
+    store.count = startTimes.size();
+    store.startView = startTimes;
+    store.endView = endTimes;
+    store.bitView = availableWords;
+    store.backing = std::move ( backing );
+    return store;
+}
+
+void AvailabilityEventStore::materialize() {
+    this->starts.assign ( this->startView.begin(), this->startView.end() );
+    this->ends.assign ( this->endView.begin(), this->endView.end() );
+    this->availableBits.assign ( this->bitView.begin(), this->bitView.end() );
+    this->backing.reset();
+    this->rebind();
+}
+
+bool AvailabilityEventStore::operator== ( const AvailabilityEventStore& other ) const {
+    if ( this->count != other.count
+        or not std::ranges::equal ( this->startView, other.startView )
+        or not std::ranges::equal ( this->endView, other.endView ) )
+        return false;
+    for ( std::size_t i = 0; i < this->count; ++i ) {
+        if ( this->available ( i ) != other.available ( i ) )
+            return false;
+    }
+    return true;
+}
+
+void AvailabilityEventStore::append ( const AvailabilityEventStore& other ) {
+    if ( this->backing )
+        this->materialize();
+    if ( ( this->count & 63 ) == 0 ) {
+        //word aligned, so the bitset can be copied a word at a time
+        this->starts.insert ( this->starts.end(), other.startView.begin(), other.startView.end() );
+        this->ends.insert ( this->ends.end(), other.endView.begin(), other.endView.end() );
+        this->availableBits.insert ( this->availableBits.end(), other.bitView.begin(), other.bitView.end() );
+        this->count += other.count;
+        this->rebind();
+        return;
+    }
+    this->reserve ( this->count + other.count );
+    for ( std::size_t i = 0; i < other.count; ++i ) {
+        this->push_back ( other.startTime ( i ), other.endTime ( i ), other.available ( i ) );
+    }
+}
+
+void AvailabilityEventStore::reserve ( std::size_t n ) {
+    if ( this->backing )
+        this->materialize();
+    this->starts.reserve ( n );
+    this->ends.reserve ( n );
+    this->availableBits.reserve ( ( n + 63 ) / 64 );
+    this->rebind();
+}
+
+void AvailabilityEventStore::clear() noexcept {
+    this->starts.clear();
+    this->ends.clear();
+    this->availableBits.clear();
+    this->count = 0;
+    this->backing.reset();
+    this->rebind();
+}
+
+std::ostream& operator << ( std::ostream& os, const AvailabilityEventStore& store ) {
+    for ( const auto ae : store ) {
+        os << ae;
+    }
+    return os;
+}
+
+} //namespace Availability
@@ -0,0 +1,380 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+#ifndef AVAILABILITYEVENTSTORE_H
+#define AVAILABILITYEVENTSTORE_H
+
+#include "AvailabilityEvent.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <ostream>
+#include <span>
+#include <vector>
+
+namespace Availability {
+using std::vector;
+
+/**
+ * @brief Columnar container of AvailabilityEvent's.
+ * Stores the events of one Charger as three parallel columns: start times, end times, and a
+ * packed bitset of the available flags. That's 16 bytes and a bit per event, in three
+ * allocations for the whole Charger, instead of a heap-allocated AvailabilityEvent and its
+ * shared_ptr control block per event.
+ *
+ * Events keep their insertion order. Reading an event by index returns it by value.
+ *
+ *      AvailabilityEventStore store;
+ *      store.push_back ( 0, 50000, true );
+ *      for ( AvailabilityEvent ae : store )
+ *          cout << ae;
+ *
+ * Hot loops should read the columns directly (startTime(i), endTime(i), available(i)).
+ *
+ * A store can also borrow its columns from memory it doesn't own, such as a memory-mapped
+ * NetworkSnapshot, see borrow(). Reading a borrowed store costs the same as reading an owned one.
+ * The first change to a borrowed store copies the columns into the store (copy-on-write).
+ *
+ * The owned columns are std::pmr vectors, so a store can keep them in a memory resource of its
+ * owner's, such as a ChargingNetwork's NetworkArena. Copies use the default resource; assigning
+ * to a store keeps its resource.
+ */
+class AvailabilityEventStore
+{
+public:
+    /**
+     * @brief Read-only iterator over the store. Dereferences to an AvailabilityEvent by value.
+     */
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = AvailabilityEvent;
+        using difference_type = std::ptrdiff_t;
+        using reference = AvailabilityEvent;
+        using pointer = void;
+
+        const_iterator() = default;
+        const_iterator ( const AvailabilityEventStore* store, std::size_t index ) : store {store}, index {index} {}
+
+        AvailabilityEvent operator*() const { return ( *store ) [index]; }
+        AvailabilityEvent operator[] ( difference_type n ) const { return ( *store ) [index + n]; }
+        const_iterator& operator++() { ++index; return *this; }
+        const_iterator operator++ ( int ) { auto old = *this; ++index; return old; }
+        const_iterator& operator--() { --index; return *this; }
+        const_iterator operator-- ( int ) { auto old = *this; --index; return old; }
+        const_iterator& operator+= ( difference_type n ) { index += n; return *this; }
+        const_iterator& operator-= ( difference_type n ) { index -= n; return *this; }
+        friend const_iterator operator+ ( const_iterator it, difference_type n ) { return it += n; }
+        friend const_iterator operator+ ( difference_type n, const_iterator it ) { return it += n; }
+        friend const_iterator operator- ( const_iterator it, difference_type n ) { return it -= n; }
+        friend difference_type operator- ( const const_iterator& a, const const_iterator& b ) {
+            return static_cast<difference_type> ( a.index ) - static_cast<difference_type> ( b.index );
+        }
+        bool operator== ( const const_iterator& other ) const { return index == other.index; }
+        auto operator<=> ( const const_iterator& other ) const { return index <=> other.index; }
+
+    private:
+        const AvailabilityEventStore* store {nullptr};
+        std::size_t index {0};
+    };
+
+    /**
+     * Default constructor. C++ default.
+     */
+    AvailabilityEventStore();
+
+    /**
+     * @brief Constructor. The columns will be allocated from resource, which must outlive the store.
+     *
+     * @param resource where to allocate the columns
+     */
+    explicit AvailabilityEventStore ( std::pmr::memory_resource* resource );
+
+    /**
+     * Copy constructor. A copy of a borrowed store borrows the same memory.
+     *
+     * @param other object to copy
+     */
+    AvailabilityEventStore ( const AvailabilityEventStore& other );
+
+    /**
+     * @brief Move constructor.
+     *
+     * @param other The object to be moved from
+     */
+    AvailabilityEventStore ( AvailabilityEventStore&& other ) noexcept;
+
+    /**
+     * Destructor. C++ default.
+     */
+    ~AvailabilityEventStore();
+
+    /**
+     * Assignment operator. A copy of a borrowed store borrows the same memory.
+     *
+     * @param other object to copy from
+     * @return object reference
+     */
+    AvailabilityEventStore& operator= ( const AvailabilityEventStore& other );
+
+    /**
+     * @brief Move assignment operator.
+     *
+     * @param other The object to be moved from
+     * @return AvailabilityEventStore&
+     */
+    AvailabilityEventStore& operator= ( AvailabilityEventStore&& other ) noexcept;
+
+    /**
+     * @brief Equality operator.
+     *
+     * @param other the object being compared with
+     * @return true if both hold the same events in the same order
+     */
+    bool operator== ( const AvailabilityEventStore& other ) const;
+
+    /**
+     * @brief Append an event.
+     *
+     * @param startTime start of the event
+     * @param endTime end of the event
+     * @param available whether the charger was available
+     */
+    void push_back ( nanoseconds_t startTime, nanoseconds_t endTime, bool available ) {
+        if ( backing )
+            materialize();
+        if ( ( count & 63 ) == 0 )
+            availableBits.push_back ( 0 );
+        if ( available )
+            availableBits.back() |= uint64_t {1} << ( count & 63 );
+        starts.push_back ( startTime );
+        ends.push_back ( endTime );
+        ++count;
+        rebind();
+    }
+
+    /**
+     * @brief Append an event.
+     *
+     * @param ae the event to append
+     */
+    void push_back ( const AvailabilityEvent& ae ) {
+        this->push_back ( ae.startTime, ae.endTime, ae.available );
+    }
+
+    /**
+     * @brief How many of the latest events pushBackCoalesced() looks thru for a duplicate.
+     * Enough for a retransmitted run of a few lines.
+     */
+    static constexpr std::size_t COALESCE_LOOKBACK {4};
+
+    /**
+     * @brief Append an event, unless it can be folded into the events already here:
+     * - if it overlaps or touches the last event and has the same available flag, the last event
+     *   is widened to cover both;
+     * - if it lies within one of the latest COALESCE_LOOKBACK events with the same available
+     *   flag, an exact duplicate for instance, it's dropped. (The earlier event may have been
+     *   widened since, so a retransmit needn't match it exactly.)
+     *
+     * Either way the union of the available time, and of the reported time, and the earliest
+     * start and latest end, are what they'd have been with the event appended, so uptime is
+     * unchanged. Only the number of events goes down.
+     *
+     * @param startTime start of the event
+     * @param endTime end of the event
+     * @param available whether the charger was available
+     * @return bool whether an event was appended
+     */
+    bool pushBackCoalesced ( nanoseconds_t startTime, nanoseconds_t endTime, bool available ) {
+        return coalesce ( *this, startTime, endTime, available );
+    }
+
+    /**
+     * @brief The rule behind pushBackCoalesced(), for anything which holds at least the latest
+     * COALESCE_LOOKBACK events of a Charger, such as a counter which only needs to know how many
+     * events a Charger will end up with. Events needs size(), startTime(i), endTime(i),
+     * available(i), push_back(startTime, endTime, available) and widenBack(startTime, endTime).
+     *
+     * @param events the events so far
+     * @param startTime start of the event
+     * @param endTime end of the event
+     * @param available whether the charger was available
+     * @return bool whether an event was appended to events
+     */
+    template<typename Events>
+    static bool coalesce ( Events& events, nanoseconds_t startTime, nanoseconds_t endTime, bool available ) {
+        const std::size_t n = events.size();
+        if ( n > 0 ) {
+            const std::size_t last = n - 1;
+            if ( events.available ( last ) == available and startTime <= events.endTime ( last )
+                and events.startTime ( last ) <= endTime ) {
+                events.widenBack ( startTime, endTime );
+                return false;
+            }
+            for ( std::size_t i = n - std::min ( n, COALESCE_LOOKBACK ); i < last; ++i ) {
+                if ( events.available ( i ) == available and events.startTime ( i ) <= startTime
+                    and endTime <= events.endTime ( i ) )
+                    return false;
+            }
+        }
+        events.push_back ( startTime, endTime, available );
+        return true;
+    }
+
+    /**
+     * @brief Widen the last event to cover [startTime, endTime) as well. There must be one.
+     *
+     * @param startTime start of the time to cover
+     * @param endTime end of the time to cover
+     */
+    void widenBack ( nanoseconds_t startTime, nanoseconds_t endTime ) {
+        if ( backing )
+            materialize();
+        starts.back() = std::min ( starts.back(), startTime );
+        ends.back() = std::max ( ends.back(), endTime );
+    }
+
+    /**
+     * @brief Append all events of another store, in order.
+     *
+     * @param other the events to append
+     */
+    void append ( const AvailabilityEventStore& other );
+
+    /**
+     * @brief Reserve room for a number of events.
+     *
+     * @param n total number of events to make room for
+     */
+    void reserve ( std::size_t n );
+
+    /**
+     * @brief Remove all events.
+     */
+    void clear() noexcept;
+
+    std::size_t size() const noexcept { return count; }
+    bool empty() const noexcept { return count == 0; }
+
+    nanoseconds_t startTime ( std::size_t i ) const noexcept { return startView[i]; }
+    nanoseconds_t endTime ( std::size_t i ) const noexcept { return endView[i]; }
+    bool available ( std::size_t i ) const noexcept { return ( bitView[i >> 6] >> ( i & 63 ) ) & 1; }
+
+    /**
+     * @brief The start time column.
+     *
+     * @return std::span<const nanoseconds_t>
+     */
+    std::span<const nanoseconds_t> startTimes() const noexcept { return startView; }
+
+    /**
+     * @brief The end time column.
+     *
+     * @return std::span<const nanoseconds_t>
+     */
+    std::span<const nanoseconds_t> endTimes() const noexcept { return endView; }
+
+    /**
+     * @brief The available flag column, 64 flags to a word. Event i is bit (i % 64) of word (i / 64).
+     *
+     * @return std::span<const uint64_t>
+     */
+    std::span<const uint64_t> availableWords() const noexcept { return bitView; }
+
+    /**
+     * @brief Make a store which reads its columns from memory it doesn't own.
+     * Nothing is copied. The columns must stay valid and unchanged for as long as backing is
+     * alive; every copy of the store holds a reference to backing.
+     *
+     * @param startTimes start time of each event
+     * @param endTimes end time of each event, same length as startTimes
+     * @param availableWords available flags, packed as in availableWords()
+     * @param backing keeps the memory behind the columns alive
+     * @return AvailabilityEventStore
+     */
+    static AvailabilityEventStore borrow ( std::span<const nanoseconds_t> startTimes, std::span<const nanoseconds_t> endTimes,
+                                          std::span<const uint64_t> availableWords, std::shared_ptr<const void> backing );
+
+    /**
+     * @brief Whether the columns are borrowed rather than owned. See borrow().
+     *
+     * @return bool
+     */
+    bool isBorrowed() const noexcept { return backing != nullptr; }
+
+    /**
+     * @brief The event at index i, by value.
+     *
+     * @param i index of the event, in insertion order
+     * @return AvailabilityEvent
+     */
+    AvailabilityEvent operator[] ( std::size_t i ) const {
+        return AvailabilityEvent ( startTime ( i ), endTime ( i ), available ( i ) );
+    }
+
+    const_iterator begin() const noexcept { return {this, 0}; }
+    const_iterator end() const noexcept { return {this, count}; }
+
+protected:
+    /**
+     * @brief Point the views at the owned columns.
+     */
+    void rebind() noexcept {
+        startView = starts;
+        endView = ends;
+        bitView = availableBits;
+    }
+
+    /**
+     * @brief Copy borrowed columns into the owned ones and let go of the backing memory.
+     */
+    void materialize();
+
+    /**
+     * @brief Start time of each event.
+     */
+    std::pmr::vector<nanoseconds_t> starts;
+    /**
+     * @brief End time of each event.
+     */
+    std::pmr::vector<nanoseconds_t> ends;
+    /**
+     * @brief Available flag of each event, 64 to a word. Event i is bit (i % 64) of word (i / 64).
+     */
+    std::pmr::vector<uint64_t> availableBits;
+    /**
+     * @brief Number of events.
+     */
+    std::size_t count {0};
+
+    /**
+     * @brief The columns as read: either the owned vectors above or borrowed memory.
+     */
+    std::span<const nanoseconds_t> startView;
+    std::span<const nanoseconds_t> endView;
+    std::span<const uint64_t> bitView;
+
+    /**
+     * @brief Keeps borrowed columns alive. nullptr when the columns are owned.
+     */
+    std::shared_ptr<const void> backing;
+};
+
+/**
+ * @brief Write to output stream. One event per line, as for vector<AvailabilityEvent>.
+ *
+ * @param os output stream
+ * @param store events to write
+ * @return std::ostream&
+ */
+std::ostream& operator << ( std::ostream& os, const AvailabilityEventStore& store );
+
+} //namespace Availability
+
+#endif // AVAILABILITYEVENTSTORE_H
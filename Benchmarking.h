@@ -0,0 +1,62 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+#ifndef BENCHMARKING_H
+#define BENCHMARKING_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace Charging {
+
+/**
+ * @brief splitmix64. Unlike the std:: engines' distributions, which differ from one standard
+ * library to the next, every number drawn from it is the same everywhere.
+ * SyntheticNetworkGenerator draws from it, and the benchmarks use it for data of their own.
+ *
+ *      SplitMix64 random {seed};
+ *      std::swap ( entries[i - 1], entries[random.next() % i] );
+ */
+class SplitMix64
+{
+public:
+    explicit SplitMix64 ( uint64_t seed ) noexcept : state {seed} {}
+
+    uint64_t next() noexcept {
+        uint64_t z = ( this->state += 0x9E3779B97F4A7C15u );
+        z = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9u;
+        z = ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EBu;
+        return z ^ ( z >> 31 );
+    }
+
+private:
+    uint64_t state;
+};
+
+/**
+ * @brief For electra2_bench, electra2_perfcheck and electra2_sweep. Timed work adds what it
+ * computes to it, so the optimizer can't drop the work.
+ *
+ *      sink = sink + factory.getReport().getEntries().size();
+ */
+inline volatile std::size_t sink {0};
+
+/**
+ * @brief Seconds taken by one run of work().
+ *
+ * @param work anything callable with no arguments
+ * @return double
+ */
+template<typename Work>
+double timeOnce ( Work&& work ) {
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+    work();
+    return std::chrono::duration<double> ( Clock::now() - start ).count();
+}
+
+} //namespace Charging
+
+#endif // BENCHMARKING_H
@@ -21,8 +21,11 @@ Charger::Charger ( chargerID_t chargerID ) {
     this->chargerID = chargerID;
 }
 
+Charger::Charger ( chargerID_t chargerID, std::pmr::memory_resource* resource, bool coalesceEvents ) :
+    chargerID {chargerID}, availabilityEvents {resource}, coalesceEvents {coalesceEvents} {
+}
+
 Charger::~Charger() { // = default
-    Debug( "~Charger\n" );
 }
 
 Charger::Charger(Charger&&) = default;
@@ -45,18 +48,26 @@ bool Charger::operator!= ( const Charger& other ) const {
 }
 
 void Charger::insertAvailabilityEvent(shared_ptr<AvailabilityEvent> ae ){
-    this->availabilityEvents.push_back(ae);
+    this->insertAvailabilityEvent(ae->startTime, ae->endTime, ae->available);
+}
+
+void Charger::insertAvailabilityEvents(const AvailabilityEventStore& events ){
+    if (not this->coalesceEvents) {
+        this->availabilityEvents.append(events);
+        return;
+    }
+    for (std::size_t i = 0; i < events.size(); ++i) {
+        this->availabilityEvents.pushBackCoalesced(events.startTime(i), events.endTime(i), events.available(i));
+    }
 }
 
 inline ostream& operator <<  (ostream& os, const Charger& c) {
-    Debug(  "Charger:[" << c.getChargerID() << "]\n" );
-    auto ae = c.getAvailabilityEvents();
-    os << ae;
+    os << c.getAvailabilityEvents();
     return os;
 }
 
 ostream& operator << ( ostream& os, const vector<shared_ptr<Charger>>& vc ) {
-    for (auto c : vc) {
+    for (const auto& c : vc) {
         os << *c.get();
     }
     return os;
@@ -69,7 +80,7 @@ ostream& operator <<  (ostream& os, const vector<Charger>& vc) {
     return os;
 }
 
-auto operator <  (const Charger c, const Charger c2) {
+auto operator <  (const Charger& c, const Charger& c2) {
     return c.getChargerID() < c2.getChargerID();
 }
 
@@ -12,16 +12,23 @@
 #include <map>
 #include <algorithm>
 #include <memory>
+#include <memory_resource>
 
 
 
 namespace Availability {
     class AvailabilityEvent; //forward declaration
     class StationAvailabilityReportFactory; //forward declaration
+    class UptimeIndex; //forward declaration
+    class IncrementalUptime; //forward declaration
+}
+namespace Charging {
+    class NetworkSnapshot; //forward declaration
 }
 using namespace Availability;
 
 #include "AvailabilityEvent.h"
+#include "AvailabilityEventStore.h"
 
 namespace ChargingNodes {
 using std::vector;
@@ -65,6 +72,17 @@ public:
 
     Charger ( chargerID_t chargerID );
 
+    /**
+     * @brief Constructor. The AvailabilityEventStore allocates from resource, which must
+     * outlive the Charger. See Charging::NetworkArena.
+     *
+     * @param chargerID the ID of the Charger
+     * @param resource where to allocate the events
+     * @param coalesceEvents whether inserted events are coalesced with the ones before them. See
+     * AvailabilityEventStore::pushBackCoalesced(). The Charger's uptime is the same either way.
+     */
+    Charger ( chargerID_t chargerID, std::pmr::memory_resource* resource, bool coalesceEvents = false );
+
     /**
      * Destructor. C++ default.
      */
@@ -120,23 +138,69 @@ public:
 
     /**
      * @brief Insert an AvailabilityEvent.
-     * Pass a shared_ptr to an AvailabilityEvent and this object will cache a copy
-     * of the pointer to use later.
+     * The event is copied into this Charger's AvailabilityEventStore; the pointer isn't kept.
      *
      * @param ae shared_ptr to an AvailabilityEvent.
      */
     void insertAvailabilityEvent(shared_ptr<AvailabilityEvent> ae );
 
     /**
-     * @brief Returns a vector of shared_ptr's to AvailabilityEvent's for this Charger
+     * @brief Insert an AvailabilityEvent given its fields.
+     * If this Charger coalesces events, the event may be merged into the one before it, or
+     * dropped as a duplicate, instead. See AvailabilityEventStore::pushBackCoalesced().
+     *
+     * @param startTime start of the event
+     * @param endTime end of the event
+     * @param available whether this Charger was available
+     */
+    void insertAvailabilityEvent(nanoseconds_t startTime, nanoseconds_t endTime, bool available ) {
+        if (this->coalesceEvents)
+            this->availabilityEvents.pushBackCoalesced(startTime, endTime, available);
+        else
+            this->availabilityEvents.push_back(startTime, endTime, available);
+    }
+
+    /**
+     * @brief Whether inserted events are coalesced, see the constructor.
      *
-     * @return std::vector< std::shared_ptr< AvailabilityEvent > >
+     * @return bool
      */
-    vector<shared_ptr<AvailabilityEvent>> getAvailabilityEvents() const {
+    bool coalescesEvents() const {
+        return this->coalesceEvents;
+    }
+
+    /**
+     * @brief Insert a batch of AvailabilityEvent's, keeping their order.
+     * Coalesced one by one if this Charger coalesces events.
+     *
+     * @param events the events to append
+     */
+    void insertAvailabilityEvents(const AvailabilityEventStore& events );
+
+    /**
+     * @brief Make room for more AvailabilityEvent's, so inserting them doesn't reallocate.
+     *
+     * @param n number of events about to be inserted
+     */
+    void reserveAvailabilityEvents(std::size_t n ) {
+        this->availabilityEvents.reserve(this->availabilityEvents.size() + n);
+    }
+
+    /**
+     * @brief Returns the AvailabilityEvent's for this Charger.
+     * A read-only view, valid as long as this Charger is and no event is inserted: nothing is
+     * copied. Copy the store to keep the events.
+     *
+     * @return const AvailabilityEventStore&
+     */
+    const AvailabilityEventStore& getAvailabilityEvents() const {
         return this->availabilityEvents;
     }
 
     friend class Availability::StationAvailabilityReportFactory;
+    friend class Charging::NetworkSnapshot;
+    friend class Availability::UptimeIndex;
+    friend class Availability::IncrementalUptime;
 
 protected:
     /**
@@ -149,8 +213,13 @@ protected:
      * An AvailabilityEvent encapsulates a single line of the [Charger Availability Reports]
      * section of the input data file. I.e., it has a charger ID, start time, end time, and
      * availability.
+     * Stored column-wise, see AvailabilityEventStore.
+     */
+    AvailabilityEventStore availabilityEvents;
+    /**
+     * @brief Whether insertAvailabilityEvent() coalesces, see the constructor.
      */
-    vector<shared_ptr<AvailabilityEvent>> availabilityEvents;
+    bool coalesceEvents {false};
 };
 
 
@@ -193,7 +262,7 @@ std::ostream& operator << ( std::ostream& os, const vector<shared_ptr<Charger>>&
  * @param c2 Second object
  * @return bool
  */
-auto operator < ( const Charger c, const Charger c2 );
+auto operator < ( const Charger& c, const Charger& c2 );
 
 } //namespace ChargingNodes
 
@@ -3,18 +3,12 @@
 #ifndef CHARGING_H_INCLUDED
 #define CHARGING_H_INCLUDED
 
-#include <iostream>
-
 //release build defines NDEBUG so we define _DEBUG if not
 #ifndef NDEBUG
 #define _DEBUG
 #endif
 
-//macro for sending debug output to cout if debug build or not if it's a release build
-#ifdef _DEBUG
-#define Debug(x) std::cout << x
-#else
-#define Debug(x)
-#endif
+//Trace() for tracing to a separate sink, compiled out of release builds. See Tracer.
+#include "Tracer.h"
 
 #endif // CHARGING_H_INCLUDED
@@ -29,24 +29,112 @@ using std::map;
 
 #include "Station.h"
 #include "StationAvailabilityReportFactory.h"
+#include "MappedFile.h"
+#include "DataFileParser.h"
+#include "ParallelFor.h"
+
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <utility>
 
 namespace Charging {
 
+namespace {
+
+/**
+ * @brief The latest few events of a Charger: all AvailabilityEventStore::coalesce() looks at.
+ * Enough to count how many events a Charger keeps when they're coalesced, without keeping them.
+ * Indices are as in the whole store, but only the latest COALESCE_LOOKBACK can be read.
+ */
+class RecentEvents
+{
+public:
+    std::size_t size() const noexcept { return this->count; }
+    nanoseconds_t startTime ( std::size_t i ) const noexcept { return this->events[i % LOOKBACK].startTime; }
+    nanoseconds_t endTime ( std::size_t i ) const noexcept { return this->events[i % LOOKBACK].endTime; }
+    bool available ( std::size_t i ) const noexcept { return this->events[i % LOOKBACK].available; }
+
+    void push_back ( nanoseconds_t startTime, nanoseconds_t endTime, bool available ) {
+        this->events[this->count++ % LOOKBACK] = {startTime, endTime, available};
+    }
+
+    void widenBack ( nanoseconds_t startTime, nanoseconds_t endTime ) {
+        Event& last = this->events[( this->count - 1 ) % LOOKBACK];
+        last.startTime = std::min ( last.startTime, startTime );
+        last.endTime = std::max ( last.endTime, endTime );
+    }
+
+private:
+    static constexpr std::size_t LOOKBACK {AvailabilityEventStore::COALESCE_LOOKBACK};
+    struct Event {
+        nanoseconds_t startTime {0};
+        nanoseconds_t endTime {0};
+        bool available {false};
+    };
+    std::array<Event, LOOKBACK> events {};
+    std::size_t count {0};
+};
+
+/**
+ * @brief Number of lines in bytes, counting a last one without a newline, as getline() would.
+ */
+uint64_t countLines ( std::string_view bytes ) {
+    return std::ranges::count ( bytes, '\n' ) + ( not bytes.empty() and bytes.back() != '\n' );
+}
+
+} //namespace
+
 ChargingNetwork::ChargingNetwork() = default;
 
-ChargingNetwork::ChargingNetwork ( const ChargingNetwork& other ) = default;
+ChargingNetwork::ChargingNetwork ( const ChargingNetwork& other ) :
+    report {other.report}, coalescing {other.coalescing}, incrementalUptime {other.incrementalUptime} {
+    //A new arena and new Stations and Chargers: addAvailabilityEvent() on either network then
+    //leaves the other one, and its incremental totals, as they were. The events themselves are
+    //copied by the Charger, or still borrowed from a snapshot until one of them changes.
+    for (const auto& [stationID, station] : other.stations) {
+        auto stationCopy = this->arena.makeShared<ChargingNodes::Station>(stationID);
+        for (const auto& charger : station->getChargers()) {
+            auto chargerCopy = this->arena.makeShared<ChargingNodes::Charger>(*charger);
+            stationCopy->insertCharger(chargerCopy);
+            this->chargers.insert({chargerCopy->getChargerID(), chargerCopy});
+        }
+        this->stations.insert({stationID, stationCopy});
+    }
+}
 
 
-ChargingNetwork::ChargingNetwork ( const std::filesystem::path& inputFile ){
+ChargingNetwork::ChargingNetwork ( const std::filesystem::path& inputFile, IngestionEngine engine, unsigned threadCount,
+                                   EventCoalescing coalescing, RunStats* stats ) : coalescing {coalescing} {
 
-    ifstream ifs {inputFile};
-    if ( !ifs.is_open() ) { //throw exception if we can't open the file
-        std::cout << ERROR_TEXT << "\n"; // See Spec Section 2.3.1
-        static const std::string explanation { "Could not open file." };
-        std::cerr << explanation << "\n"; // See Spec Section 2.3.2
-        throw std::filesystem::filesystem_error ( explanation, inputFile,  std::error_code() );
+    //mmap() needs a regular file. Anything else (a pipe, /dev/stdin, ...) goes thru the stream reader.
+    std::error_code ec;
+    if ( engine != IngestionEngine::STREAM and std::filesystem::is_regular_file ( inputFile, ec ) ) {
+        this->readMapped ( inputFile, engine == IngestionEngine::PARALLEL ? resolveThreadCount ( threadCount ) : 1, stats );
+    } else {
+        this->readStream ( inputFile, stats );
+    }
+
+    Trace( PARSE, INFO, "network read: stations, chargers", this->stations.size(), this->chargers.size() );
+}
+
+void ChargingNetwork::failToOpen ( const std::filesystem::path& inputFile, std::error_code ec ) {
+    std::cout << ERROR_TEXT << "\n"; // See Spec Section 2.3.1
+    static const std::string explanation { "Could not open file." };
+    std::cerr << explanation << "\n"; // See Spec Section 2.3.2
+    throw std::filesystem::filesystem_error ( explanation, inputFile, ec );
+}
+
+void ChargingNetwork::readStream ( const std::filesystem::path& inputFile, RunStats* stats ) {
+
+    ifstream ifs;
+    {
+        RunStats::Scope phase {stats, "open"};
+        ifs.open ( inputFile );
+        if ( !ifs.is_open() ) { //throw exception if we can't open the file
+            failToOpen ( inputFile );
+        }
     }
-    Debug( "\n" );
 
     enum class Modes { NONE, STATIONS, AVAILABILITY_REPORTS};
     Modes mode {Modes::NONE};
@@ -54,14 +142,30 @@ ChargingNetwork::ChargingNetwork ( const std::filesystem::path& inputFile ){
     string line;
     auto counter = 0;
 
+    //The stations phase runs up to the first [Charger Availability Reports] header, the
+    //availability phase from there to the end
+    std::optional<RunStats::Scope> phase;
+    phase.emplace ( stats, "stations" );
+    bool availabilityPhase {false};
+    uint64_t lines {0};
+    uint64_t bytes {0};
+
     while ( std::getline ( ifs, line ) ) {
-        Debug( "\nLine " << counter++ << ": " << line << "\n" );
+        ++counter;
+        ++lines;
+        bytes += line.size() + ( ifs.eof() ? 0 : 1 ); //the last line may have no newline
         if ( line == ChargingNetwork::STATIONS_HEADER ) {
-            Debug( "Stations header\n" );
+            Trace( PARSE, DEBUG, "stations header: line", counter );
             mode = Modes::STATIONS;
         } else if ( line == ChargingNetwork::CHARGERAVAILABILITY_HEADER ) {
-            Debug( "Availability header\n" );
+            Trace( PARSE, DEBUG, "availability header: line", counter );
             mode = Modes::AVAILABILITY_REPORTS;
+            if ( not availabilityPhase ) {
+                phase->count ( lines, 0, bytes );
+                lines = bytes = 0;
+                phase.emplace ( stats, "availability" );
+                availabilityPhase = true;
+            }
         } else if ( line == "" ) {
             ; // Do nothing if blank line
         } else {
@@ -76,35 +180,15 @@ ChargingNetwork::ChargingNetwork ( const std::filesystem::path& inputFile ){
                 // we would fall thru to the STATIONS case.
                 break;
             case Modes::STATIONS:
-                Debug( "case STATIONS:\n" );
                 iss >>  stationID;
-                Debug( "\nstationID: " << stationID << ":" );
-
 
                 while ( iss >> chargerID ) {
-                    Debug( chargerID << "," );
-
-                    //create a Charger
-                    auto c = std::make_shared<ChargingNodes::Charger>(chargerID);
-                    this->chargers.insert({chargerID, c});
-
-                    //insert a Charger pointer in the associated Station
-                    auto result = this->stations.find(stationID);
-                    if (result != this->stations.end()) { //if the Station already exists
-                        auto& station = result->second;
-                        station->insertCharger(c);
-                    } else {    //if not, create the Station
-                        auto station = std::make_shared<ChargingNodes::Station>(stationID);
-                        station->insertCharger(c);
-                        this->stations.insert({stationID, station});
-                    }
-
+                    Trace( PARSE, VERBOSE, "station charger", stationID, chargerID );
+                    this->insertCharger ( stationID, chargerID );
                 }
                 break;
             case Modes::AVAILABILITY_REPORTS: {
-                Debug( "case AVAILABILITY_REPORTS:\n" );
                 iss >>  chargerID;
-                Debug( "chargerID: " << chargerID << ":" );
 
                 //create an AvailabilityEvent for the current line, and insert
                 //it into the associated Charger
@@ -116,28 +200,11 @@ ChargingNetwork::ChargingNetwork ( const std::filesystem::path& inputFile ){
                 iss >> startTime;
                 iss >> endTime;
 
-                //handle strange condition of startTime greater than endTime.
-                //We set endTime to equal startTime.
-                //See Spec Section 4.3
-                if (startTime > endTime)
-                    endTime = startTime;
-                nanoseconds_t startTimeObj {startTime};
-                nanoseconds_t endTimeObj {endTime};
-
                 iss >> availableText;
                 availableBool = ( availableText == "true" ) ? true : false;
+                Trace( PARSE, VERBOSE, "availability report: charger, start", chargerID, startTime );
 
-                //find the associated Charger
-                const auto result = chargers.find(chargerID);
-                if (result == chargers.end()) {
-                    assert(false); // Should never get here bc there should always be a Charger for this chargerID
-                } else {
-                    auto& charger = result->second;
-                    charger->getChargerID();
-                    auto ae = std::make_shared<AvailabilityEvent>( startTimeObj, endTimeObj, availableBool );
-                    charger->insertAvailabilityEvent(ae );
-                }
-
+                this->insertAvailabilityEvent ( chargerID, startTime, endTime, availableBool );
             }
                 break;
             default:
@@ -145,27 +212,351 @@ ChargingNetwork::ChargingNetwork ( const std::filesystem::path& inputFile ){
             }
         }
     }
+    if ( *phase )
+        phase->count ( lines, this->getEventCount(), bytes );
+}
+
+void ChargingNetwork::readMapped ( const std::filesystem::path& inputFile, unsigned threadCount, RunStats* stats ) {
+    MappedFile mappedFile;
+    {
+        RunStats::Scope phase {stats, "open"};
+        try {
+            mappedFile = MappedFile ( inputFile );
+        } catch ( const std::filesystem::filesystem_error& ex ) {
+            failToOpen ( inputFile, ex.code() );
+        }
+        phase.count ( 0, 0, mappedFile.view().size() );
+    }
+    if ( threadCount > 1 ) {
+        this->parseParallel ( mappedFile.view(), threadCount, stats );
+        return;
+    }
+    std::string_view bytes = mappedFile.view();
+    const auto section = this->parseTopology ( bytes, stats );
+    RunStats::Scope phase {stats, "availability"};
+    if ( section == DataFileParser::Section::AVAILABILITY_REPORTS )
+        this->reserveAvailabilityEvents ( bytes );
+    this->parse ( bytes, section );
+    if ( phase )
+        phase.count ( countLines ( bytes ), this->getEventCount(), bytes.size() );
+}
 
-    Debug( "\n" );
-    Debug( "cout << chargers;\n" );
-    Debug( "cout << stations;\n" );
-    Debug( stations );
-    Debug( "\nC++ version: " << __cplusplus <<"\n" );
+DataFileParser::Section ChargingNetwork::parseTopology ( std::string_view& bytes, RunStats* stats ) {
+    using Section = DataFileParser::Section;
+    RunStats::Scope phase {stats, "stations"};
+    const std::string_view all = bytes;
+    Section section {Section::NONE};
+    std::string_view line;
+    uint64_t lines {0};
+    while ( section != Section::AVAILABILITY_REPORTS and DataFileParser::nextLine ( bytes, line ) ) {
+        this->parseLine ( line, section );
+        ++lines;
+    }
+    phase.count ( lines, 0, all.size() - bytes.size() );
+    return section;
+}
+
+void ChargingNetwork::reserveAvailabilityEvents ( std::string_view bytes ) {
+    this->freezeTopology();
+    vector<std::size_t> counts ( this->denseChargers.size() );
+    const bool coalesce = ( this->coalescing == EventCoalescing::MERGE );
+    vector<RecentEvents> recentEvents ( coalesce ? counts.size() : 0 );
+    DataFileParser::Section section {DataFileParser::Section::AVAILABILITY_REPORTS};
+    DataFileParser::AvailabilityRecord record;
+    std::string_view line;
+    while ( DataFileParser::nextLine ( bytes, line ) ) {
+        if ( DataFileParser::isHeader ( line, section ) )
+            break;
+        if ( coalesce ) {
+            if ( not DataFileParser::parseAvailabilityLine ( line, record ) )
+                continue;
+            const uint32_t charger = this->chargerIndex.find ( record.chargerID );
+            if ( charger == DenseIdMap::NOT_FOUND )
+                continue;
+            DataFileParser::clampEndTime ( record.startTime, record.endTime );
+            if ( AvailabilityEventStore::coalesce ( recentEvents[charger], record.startTime, record.endTime, record.available ) )
+                ++counts[charger];
+            continue;
+        }
+        chargerID_t chargerID;
+        if ( not DataFileParser::parseChargerID ( line, chargerID ) )
+            continue;
+        const uint32_t charger = this->chargerIndex.find ( chargerID );
+        if ( charger != DenseIdMap::NOT_FOUND )
+            ++counts[charger];
+    }
+    for ( std::size_t i = 0; i < counts.size(); ++i ) {
+        this->denseChargers[i]->reserveAvailabilityEvents ( counts[i] );
+    }
+}
+
+DataFileParser::Section ChargingNetwork::parse ( std::string_view bytes, DataFileParser::Section section ) {
+    std::string_view line;
+    while ( DataFileParser::nextLine ( bytes, line ) ) {
+        this->parseLine ( line, section );
+    }
+    return section;
+}
+
+void ChargingNetwork::parseLine ( std::string_view line, DataFileParser::Section& section ) {
+    using Section = DataFileParser::Section;
+    if ( line.empty() )
+        return;
+    if ( DataFileParser::isHeader ( line, section ) ) {
+        Trace( PARSE, DEBUG, "header: section", static_cast<int> ( section ) );
+        return;
+    }
+
+    switch ( section ) {
+    case Section::NONE:
+        //no header yet, so there's nothing this line could be
+        break;
+    case Section::STATIONS: {
+        stationID_t stationID;
+        DataFileParser::parseStationsLine ( line, stationID, [&] ( chargerID_t chargerID ) {
+            Trace( PARSE, VERBOSE, "station charger", stationID, chargerID );
+            this->insertCharger ( stationID, chargerID );
+        } );
+    }
+        break;
+    case Section::AVAILABILITY_REPORTS: {
+        DataFileParser::AvailabilityRecord record;
+        if ( DataFileParser::parseAvailabilityLine ( line, record ) ) {
+            Trace( PARSE, VERBOSE, "availability report: charger, start", record.chargerID, record.startTime );
+            this->insertAvailabilityEvent ( record.chargerID, record.startTime, record.endTime, record.available );
+        }
+    }
+        break;
+    }
+}
+
+DataFileParser::Section ChargingNetwork::parseParallel ( std::string_view bytes, unsigned threadCount, RunStats* stats ) {
+    //Everything up to and including the [Charger Availability Reports] header is parsed here, on
+    //this thread. That's the topology, which is small, and every Charger has to exist before the
+    //chunks are merged.
+    const auto section = this->parseTopology ( bytes, stats );
+
+    RunStats::Scope phase {stats, "availability"};
+    const auto end = this->parseChunks ( bytes, section, threadCount );
+    if ( phase )
+        phase.count ( countLines ( bytes ), this->getEventCount(), bytes.size() );
+    return end;
+}
+
+DataFileParser::Section ChargingNetwork::parseChunks ( std::string_view bytes, DataFileParser::Section section, unsigned threadCount ) {
+    using Section = DataFileParser::Section;
+
+    //Not worth starting threads for less than this much per chunk
+    static constexpr std::size_t MIN_CHUNK_BYTES {1 << 20};
+    //More chunks than threads, so a thread which finishes early can pick up another one
+    const std::size_t chunkCount = std::min<std::size_t> ( std::size_t {threadCount} * 4, bytes.size() / MIN_CHUNK_BYTES );
+    if ( chunkCount <= 1 )
+        return this->parse ( bytes, section );
+
+    //Chunk boundaries: evenly spaced, then moved forward to just past the next newline, so each
+    //line lands in exactly one chunk.
+    vector<std::size_t> boundaries {0};
+    for ( std::size_t i = 1; i < chunkCount; ++i ) {
+        std::size_t boundary = std::max ( bytes.size() * i / chunkCount, boundaries.back() );
+        if ( boundary > 0 and bytes[boundary - 1] != '\n' ) {
+            const auto newline = bytes.find ( '\n', boundary );
+            boundary = ( newline == std::string_view::npos ) ? bytes.size() : newline + 1;
+        }
+        boundaries.push_back ( boundary );
+    }
+    boundaries.push_back ( bytes.size() );
+
+    //Each chunk collects its events per Charger: a store per Charger it saw, found thru a flat
+    //table indexed by the Charger's dense index.
+    struct Chunk {
+        vector<uint32_t> storeOf;
+        vector<std::pair<uint32_t, AvailabilityEventStore>> events;
+        bool sawHeader {false};
+    };
+    vector<Chunk> chunks ( chunkCount );
+    this->freezeTopology();
+    //Each chunk coalesces its own events; insertAvailabilityEvents() then coalesces across chunks
+    const bool coalesce = ( this->coalescing == EventCoalescing::MERGE );
+
+    parallelFor ( chunkCount, threadCount, [&] ( std::size_t i ) {
+        std::string_view remaining = bytes.substr ( boundaries[i], boundaries[i + 1] - boundaries[i] );
+        std::string_view chunkLine;
+        Section chunkSection {Section::AVAILABILITY_REPORTS};
+        DataFileParser::AvailabilityRecord record;
+        auto& chunk = chunks[i];
+        chunk.storeOf.assign ( this->denseChargers.size(), DenseIdMap::NOT_FOUND );
+        while ( DataFileParser::nextLine ( remaining, chunkLine ) ) {
+            if ( chunkLine.empty() )
+                continue;
+            if ( DataFileParser::isHeader ( chunkLine, chunkSection ) ) {
+                //Another section after the availability reports. Rare enough that we don't
+                //try to be clever; the whole section is parsed again on one thread.
+                chunk.sawHeader = true;
+                return;
+            }
+            if ( DataFileParser::parseAvailabilityLine ( chunkLine, record ) ) {
+                Trace( PARSE, VERBOSE, "availability report: charger, start", record.chargerID, record.startTime );
+                DataFileParser::clampEndTime ( record.startTime, record.endTime );
+                const uint32_t charger = this->chargerIndex.find ( record.chargerID );
+                assert(charger != DenseIdMap::NOT_FOUND); // Should never get here bc there should always be a Charger for this chargerID
+                if ( charger == DenseIdMap::NOT_FOUND )
+                    continue;
+                uint32_t& store = chunk.storeOf[charger];
+                if ( store == DenseIdMap::NOT_FOUND ) {
+                    store = static_cast<uint32_t> ( chunk.events.size() );
+                    chunk.events.emplace_back ( charger, AvailabilityEventStore() );
+                }
+                if ( coalesce )
+                    chunk.events[store].second.pushBackCoalesced ( record.startTime, record.endTime, record.available );
+                else
+                    chunk.events[store].second.push_back ( record.startTime, record.endTime, record.available );
+            }
+        }
+        Trace( PARSE, DEBUG, "chunk parsed: chunk, Chargers", i, chunk.events.size() );
+    } );
+
+    if ( std::ranges::any_of ( chunks, &Chunk::sawHeader ) ) {
+        Trace( PARSE, DEBUG, "chunks saw another header, parsing serially" );
+        return this->parse ( bytes, section );
+    }
+
+    //Every Charger's events are allocated once, at their final size (or a few more, if events
+    //are coalesced across chunk boundaries)
+    vector<std::size_t> counts ( this->denseChargers.size() );
+    for ( const auto& chunk : chunks ) {
+        for ( const auto& [charger, events] : chunk.events )
+            counts[charger] += events.size();
+    }
+    for ( std::size_t i = 0; i < counts.size(); ++i ) {
+        this->denseChargers[i]->reserveAvailabilityEvents ( counts[i] );
+    }
+
+    //Merge in chunk order. Every chunk keeps its lines in file order, so each Charger gets its
+    //events in file order too, whichever thread parsed what.
+    for ( auto& chunk : chunks ) {
+        for ( auto& [charger, events] : chunk.events ) {
+            this->denseChargers[charger]->insertAvailabilityEvents ( events );
+        }
+        chunk.events.clear();
+    }
+    return section; //no chunk saw another header
+}
+
+void ChargingNetwork::insertCharger ( stationID_t stationID, chargerID_t chargerID ) {
+    //create a Charger
+    auto c = this->arena.makeShared<ChargingNodes::Charger>(chargerID, this->arena.resource(),
+                                                            this->coalescing == EventCoalescing::MERGE);
+    this->chargers.insert({chargerID, c});
+    this->topologyFrozen = false; //a [Stations] section after the availability reports
+
+    //insert a Charger pointer in the associated Station
+    auto result = this->stations.find(stationID);
+    if (result != this->stations.end()) { //if the Station already exists
+        auto& station = result->second;
+        station->insertCharger(c);
+    } else {    //if not, create the Station
+        auto station = this->arena.makeShared<ChargingNodes::Station>(stationID);
+        station->insertCharger(c);
+        this->stations.insert({stationID, station});
+    }
+}
+
+void ChargingNetwork::insertAvailabilityEvent ( chargerID_t chargerID, nanoseconds_t startTime, nanoseconds_t endTime, bool available ) {
+    //find the associated Charger
+    Charger* const charger = this->findCharger(chargerID);
+    if (charger == nullptr) {
+        assert(false); // Should never get here bc there should always be a Charger for this chargerID
+    } else {
+        //handle strange condition of startTime greater than endTime.
+        //We set endTime to equal startTime.
+        //See Spec Section 4.3
+        DataFileParser::clampEndTime( startTime, endTime );
+        charger->insertAvailabilityEvent( startTime, endTime, available );
+    }
+}
+
+Charger* ChargingNetwork::findCharger ( chargerID_t chargerID ) {
+    if (not this->topologyFrozen)
+        this->freezeTopology();
+    const uint32_t index = this->chargerIndex.find(chargerID);
+    return (index == DenseIdMap::NOT_FOUND) ? nullptr : this->denseChargers[index];
+}
+
+void ChargingNetwork::freezeTopology() {
+    vector<chargerID_t> chargerIDs;
+    chargerIDs.reserve(this->chargers.size());
+    this->denseChargers.clear();
+    this->denseChargers.reserve(this->chargers.size());
+    for (const auto& [chargerID, charger] : this->chargers) {
+        chargerIDs.push_back(chargerID);
+        this->denseChargers.push_back(charger.get());
+    }
+    this->chargerIndex = DenseIdMap(chargerIDs);
+    this->topologyFrozen = true;
 }
 
 ChargingNetwork::~ChargingNetwork()= default;
 
-ChargingNetwork& ChargingNetwork::operator= ( const ChargingNetwork& other ) = default;
+ChargingNetwork& ChargingNetwork::operator= ( const ChargingNetwork& other ) {
+    if (this != &other) {
+        ChargingNetwork copy {other};
+        *this = std::move(copy);
+    }
+    return *this;
+}
 
 ChargingNetwork::ChargingNetwork(ChargingNetwork&&) = default;
 
 ChargingNetwork& ChargingNetwork::operator= (ChargingNetwork&& other) = default;
 
-StationAvailabilityReport ChargingNetwork::getStationAvailabilityReport() const {
-    auto factory = Availability::StationAvailabilityReportFactory(this->stations);
+bool ChargingNetwork::addAvailabilityEvent ( chargerID_t chargerID, nanoseconds_t startTime, nanoseconds_t endTime, bool available ) {
+    Charger* const charger = this->findCharger( chargerID );
+    if (charger == nullptr)
+        return false;
+    DataFileParser::clampEndTime( startTime, endTime ); //See Spec Section 4.3
+
+    if (not this->incrementalUptime)
+        this->incrementalUptime.emplace( this->stations, this->chargers ); //before the event is added, or it'd count twice
+    this->incrementalUptime->insert( chargerID, startTime, endTime, available );
+    charger->insertAvailabilityEvent( startTime, endTime, available );
+    this->uptimeIndex.reset(); //rebuilt on the next windowed report
+    return true;
+}
+
+std::size_t ChargingNetwork::getEventCount() const {
+    std::size_t count {0};
+    for (const auto& [chargerID, charger] : this->chargers)
+        count += charger->getAvailabilityEvents().size();
+    return count;
+}
+
+StationAvailabilityReport ChargingNetwork::getStationAvailabilityReport( unsigned threadCount, RunStats* stats ) const {
+    if (this->incrementalUptime) {
+        RunStats::Scope phase {stats, "report incremental"};
+        return this->incrementalUptime->getReport();
+    }
+    auto factory = Availability::StationAvailabilityReportFactory(this->stations, threadCount,
+                                                                 StationAvailabilityReportFactory::UptimeEngine::KWAY_MERGE,
+                                                                 IntervalSort::Algorithm::COMPARISON, stats);
     return factory.getReport();
 }
 
+UptimeSeriesReport ChargingNetwork::getUptimeSeriesReport( nanoseconds_t bucketWidth, unsigned threadCount ) const {
+    auto factory = Availability::StationAvailabilityReportFactory(this->stations, threadCount);
+    return factory.getSeriesReport( bucketWidth );
+}
+
+std::optional<float> ChargingNetwork::getChargerUptime( chargerID_t chargerID ) const {
+    const auto result = this->chargers.find( chargerID );
+    if ( result == this->chargers.end() )
+        return std::nullopt;
+    return Availability::StationAvailabilityReportFactory::chargerUptimeFraction( *result->second );
+}
+
+StationAvailabilityReport ChargingNetwork::getStationAvailabilityReport( nanoseconds_t windowStart, nanoseconds_t windowEnd ) const {
+    return this->uptimeIndex.get( this->stations )->getReport( windowStart, windowEnd );
+}
+
 std::ostream& operator <<  (std::ostream& os, const map<ChargingNodes::stationID_t, shared_ptr<ChargingNodes::Station>>& m) {
     for (const auto&[ k, v ] : m) { //key is stationID, value is the Station (pointer to Station, actually)
         os << *v.get() << "\n";
@@ -16,8 +16,18 @@ using std::string;
 using std::map;
 
 #include <filesystem>
+#include <optional>
+#include <string_view>
+#include <system_error>
 
 #include "StationAvailabilityReport.h"
+#include "DataFileParser.h"
+#include "DenseIdMap.h"
+#include "NetworkArena.h"
+#include "IncrementalUptime.h"
+#include "UptimeIndex.h"
+#include "UptimeSeriesReport.h"
+#include "RunStats.h"
 
 #include <memory>
 using std::unique_ptr;
@@ -40,13 +50,34 @@ namespace Charging {
 class ChargingNetwork
 {
 public:
+    /**
+     * @brief How the input data file is read.
+     * STREAM reads it with ifstream and getline, one istringstream per line.
+     * MAPPED memory-maps it and parses the lines in place, without a string or stream per line.
+     * PARALLEL memory-maps it too, and splits the [Charger Availability Reports] section into
+     * chunks which are parsed on several threads.
+     * All of them build the same object graph, with each Charger's events in file order.
+     */
+    enum class IngestionEngine { STREAM, MAPPED, PARALLEL };
+
+    /**
+     * @brief What happens to each availability report as it's read.
+     * NONE keeps every report as its own event.
+     * MERGE merges a report into the Charger's previous one when they overlap or touch and have
+     * the same availability, and drops exact duplicates of recent reports (retransmits). See
+     * AvailabilityEventStore::pushBackCoalesced(). Fewer events are kept, and so less memory and
+     * less sorting, but every report is the same as with NONE.
+     */
+    enum class EventCoalescing { NONE, MERGE };
+
     /**
      * Default constructor. Using Rule of Zero for five basic methods.
      */
     ChargingNetwork();
 
     /**
-     * Copy constructor. Default.
+     * Copy constructor. Copies the Stations and Chargers too, into an arena of its own, so that
+     * adding availability reports to one network doesn't change the other.
      *
      * @param other the object being copied from
      *
@@ -62,6 +93,14 @@ public:
      *      ChargingNetwork cn {chargingNetworkDataFile};
      *
      * @param inputFile The path to the input data file
+     * @param engine How to read the file. MAPPED unless asked otherwise. Files that can't be
+     * mapped (pipes, for instance) are always read with STREAM.
+     * @param threadCount Number of threads for IngestionEngine::PARALLEL. 0 means one per hardware
+     * thread. Ignored by the other engines.
+     * @param coalescing whether availability reports are coalesced as they're read. This and
+     * every Charger created later keep it.
+     * @param stats where to record the open, stations and availability phases of reading the
+     * file. nullptr records nothing.
      * \internal
      * @brief Construct the ChargingNetwork object graph by reading data from the passed inputFile.
      *
@@ -83,7 +122,9 @@ public:
      *
      * \endinternal
      */
-    ChargingNetwork ( const ::std::filesystem::path& inputFile );
+    ChargingNetwork ( const ::std::filesystem::path& inputFile, IngestionEngine engine = IngestionEngine::MAPPED,
+                      unsigned threadCount = 0, EventCoalescing coalescing = EventCoalescing::NONE,
+                      RunStats* stats = nullptr );
 
     /**
      * Destructor. Default.
@@ -92,7 +133,7 @@ public:
 
     /**
      * @brief Assignment operator.
-     * Default.
+     * Copies, as the copy constructor does.
      *
      * @param other the object being assigned from
      * @return object reference
@@ -114,6 +155,40 @@ public:
      */
     ChargingNetwork& operator= (ChargingNetwork&& other);
 
+    /**
+     * @brief Add a newly arrived availability report for a Charger.
+     * The same as a line of the [Charger Availability Reports] section, but after the fact: the
+     * event is added to the Charger, and the next report includes it. See Spec Section 4.3 for
+     * startTime greater than endTime.
+     *
+     * The first call takes in every event so far (a full pass); after that each call updates
+     * just its Station's available time and reporting span, in O(log n), and
+     * getStationAvailabilityReport() divides the maintained totals instead of recomputing them.
+     * The report is exactly the one a fresh ChargingNetwork with the same events would give.
+     *
+     *      ChargingNetwork cn {chargingNetworkDataFile};
+     *      cn.addAvailabilityEvent ( 1001, startTime, endTime, true );
+     *      cout << cn.getStationAvailabilityReport();
+     *
+     * @param chargerID the Charger which reported
+     * @param startTime start of the reported period
+     * @param endTime end of the reported period
+     * @param available whether the Charger was available for the period
+     * @return false if there's no Charger with this chargerID. Nothing is added.
+     */
+    bool addAvailabilityEvent ( chargerID_t chargerID, nanoseconds_t startTime, nanoseconds_t endTime, bool available );
+
+    /**
+     * @brief Add a newly arrived availability report for a Charger. See above.
+     *
+     * @param chargerID the Charger which reported
+     * @param ae the reported event
+     * @return false if there's no Charger with this chargerID
+     */
+    bool addAvailabilityEvent ( chargerID_t chargerID, const AvailabilityEvent& ae ) {
+        return this->addAvailabilityEvent ( chargerID, ae.startTime, ae.endTime, ae.available );
+    }
+
     /**
      * @brief Get the station availabilty report.
      *
@@ -122,23 +197,263 @@ public:
      *      cout << report;
      *
      *
+     * @param threadCount number of threads to compute the Stations on. 1 computes them on the
+     * calling thread, 0 uses one thread per hardware thread. The report is the same either way.
+     * @param stats where to record the phases of computing the report. nullptr records nothing.
      * @return StationAvailabilityReport
      */
-    StationAvailabilityReport getStationAvailabilityReport() const;
+    StationAvailabilityReport getStationAvailabilityReport( unsigned threadCount = 1, RunStats* stats = nullptr ) const;
+
+    /**
+     * @brief Get the station availability report for a time window.
+     * Each Station's uptime counts only the part of [windowStart, windowEnd) the Station reported
+     * for. Stations which reported nothing during the window are left out. See UptimeIndex.
+     * Throws std::invalid_argument if windowStart isn't before windowEnd.
+     *
+     *      ChargingNetwork cn {chargingNetworkDataFile};
+     *      cout << cn.getStationAvailabilityReport ( outageStart, outageEnd );
+     *
+     * The first call builds an index of the network; every call after that costs O(log n) per
+     * Station, whatever the window.
+     *
+     * @param windowStart start of the window
+     * @param windowEnd end of the window, not included
+     * @return StationAvailabilityReport
+     */
+    StationAvailabilityReport getStationAvailabilityReport( nanoseconds_t windowStart, nanoseconds_t windowEnd ) const;
+
+    /**
+     * @brief Get the bucketed uptime report: available and reporting time per Station per bucket.
+     * Throws std::length_error if that's more than UptimeSeriesReport::MAX_BUCKETS buckets.
+     *
+     *      ChargingNetwork cn {chargingNetworkDataFile};
+     *      cout << cn.getUptimeSeriesReport ( 3600'000'000'000 ); //hourly
+     *
+     * @param bucketWidth width of a bucket, greater than 0
+     * @param threadCount as for getStationAvailabilityReport()
+     * @return UptimeSeriesReport
+     */
+    UptimeSeriesReport getUptimeSeriesReport( nanoseconds_t bucketWidth, unsigned threadCount = 1 ) const;
+
+    /**
+     * @brief Get the uptime of one Charger over its own reporting span.
+     * See StationAvailabilityReportFactory::chargerUptimeFraction(). O(events of the Charger).
+     *
+     * @param chargerID the Charger
+     * @return std::optional<float> nothing if there's no such Charger
+     */
+    std::optional<float> getChargerUptime( chargerID_t chargerID ) const;
+
+    /**
+     * @brief Returns the Station's of this network, keyed by station ID.
+     * A read-only view, valid as long as this network is and its topology doesn't change;
+     * nothing is copied. Together with Station::getChargers() and
+     * Charger::getAvailabilityEvents() the whole network can be walked without an allocation.
+     *
+     *      for ( const auto& [stationID, station] : cn.getStations() )
+     *          for ( const auto& charger : station->getChargers() )
+     *              total += charger->getAvailabilityEvents().size();
+     *
+     * @return const map<stationID_t, shared_ptr<Station>>&
+     */
+    const map<stationID_t, shared_ptr<Station>>& getStations() const { return this->stations; }
+
+    /**
+     * @brief Returns the Charger's of this network, keyed by charger ID. A read-only view, as
+     * getStations().
+     *
+     * @return const map<chargerID_t, shared_ptr<Charger>>&
+     */
+    const map<chargerID_t, shared_ptr<Charger>>& getChargers() const { return this->chargers; }
+
+    /**
+     * @brief Returns the number of availability events kept by all the Charger's of this network.
+     * Fewer than the reports read if they're coalesced. O(Chargers).
+     *
+     * @return std::size_t
+     */
+    std::size_t getEventCount() const;
+
     /**
      * @brief Text to print when there is an error.
      * See Spec Section 2.3.1.
      *
      */
     inline static const ::std::string_view ERROR_TEXT {"ERROR"};
+
+    friend class NetworkSnapshot;
+    friend class DataFileFollower;
 protected:
+    /**
+     * @brief Read the input data file with ifstream and getline. See IngestionEngine::STREAM.
+     *
+     * @param inputFile The path to the input data file
+     * @param stats where to record the phases of reading it. nullptr records nothing.
+     */
+    void readStream ( const ::std::filesystem::path& inputFile, RunStats* stats = nullptr );
+
+    /**
+     * @brief Read the input data file by memory-mapping it.
+     * See IngestionEngine::MAPPED and IngestionEngine::PARALLEL.
+     *
+     * @param inputFile The path to the input data file
+     * @param threadCount Number of parsing threads. 1 parses on the calling thread only.
+     * @param stats where to record the phases of reading it. nullptr records nothing.
+     */
+    void readMapped ( const ::std::filesystem::path& inputFile, unsigned threadCount, RunStats* stats = nullptr );
+
+    /**
+     * @brief Parse the contents of an input data file which is already in memory.
+     *
+     * @param bytes the contents of the file
+     * @param section the section bytes starts in. NONE for a whole file.
+     * @return DataFileParser::Section the section bytes ends in
+     */
+    DataFileParser::Section parse ( ::std::string_view bytes, DataFileParser::Section section = DataFileParser::Section::NONE );
+
+    /**
+     * @brief Parse the lines of an input data file up to and including the
+     * [Charger Availability Reports] header: the topology.
+     *
+     * @param bytes the whole contents of the file. Advanced past what was parsed.
+     * @param stats where to record it, as the stations phase. nullptr records nothing.
+     * @return DataFileParser::Section the section the rest of bytes starts in
+     */
+    DataFileParser::Section parseTopology ( ::std::string_view& bytes, RunStats* stats = nullptr );
+
+    /**
+     * @brief Count the availability reports for each Charger and reserve room for them, so that
+     * every Charger's events are allocated once, at their final size, instead of growing (and
+     * leaving the old buffers behind in the arena). A quick pass: only the charger ID of each
+     * line is parsed. Unless reports are coalesced: then each line is parsed in full, and
+     * coalesced against the latest few events of its Charger, so the count is what's kept.
+     *
+     * @param bytes [Charger Availability Reports] lines. Counting stops at another header.
+     */
+    void reserveAvailabilityEvents ( ::std::string_view bytes );
+
+    /**
+     * @brief Parse a whole input data file, with the [Charger Availability Reports] section split
+     * into chunks which are parsed on up to threadCount threads.
+     * Each chunk collects its events per chargerID_t. The chunks are then merged into the Chargers
+     * in file order, so every Charger ends up with exactly the events, in exactly the order, that
+     * parse() would have given it.
+     *
+     * @param bytes the whole contents of the file
+     * @param threadCount maximum number of threads
+     * @param stats where to record the stations and availability phases. nullptr records nothing.
+     * @return DataFileParser::Section the section bytes ends in
+     */
+    DataFileParser::Section parseParallel ( ::std::string_view bytes, unsigned threadCount, RunStats* stats = nullptr );
+
+    /**
+     * @brief The [Charger Availability Reports] half of parseParallel().
+     *
+     * @param bytes the rest of the file, after the topology
+     * @param section the section bytes starts in
+     * @param threadCount maximum number of threads
+     * @return DataFileParser::Section the section bytes ends in
+     */
+    DataFileParser::Section parseChunks ( ::std::string_view bytes, DataFileParser::Section section, unsigned threadCount );
+
+    /**
+     * @brief Handle one line of the input data file.
+     *
+     * @param line the line, without its newline
+     * @param section the section we're in. Updated if line is a header.
+     */
+    void parseLine ( ::std::string_view line, DataFileParser::Section& section );
+
+    /**
+     * @brief Create a Charger and add it to its Station, creating the Station if need be.
+     * One call for each charger ID on a [Stations] line.
+     *
+     * @param stationID the Station the Charger belongs to
+     * @param chargerID the Charger to create
+     */
+    void insertCharger ( stationID_t stationID, chargerID_t chargerID );
+
+    /**
+     * @brief Create an AvailabilityEvent and add it to its Charger.
+     * One call for each [Charger Availability Reports] line.
+     * See DataFileParser::clampEndTime().
+     *
+     * @param chargerID the Charger which reported
+     * @param startTime start of the reported period
+     * @param endTime end of the reported period
+     * @param available whether the Charger was available for the period
+     */
+    void insertAvailabilityEvent ( chargerID_t chargerID, nanoseconds_t startTime, nanoseconds_t endTime, bool available );
+
+    /**
+     * @brief The Charger a chargerID resolves to, via the dense index.
+     * Freezes the topology first if a Charger was created since it was last frozen.
+     *
+     * @param chargerID the Charger
+     * @return Charger* nullptr if there's no such Charger
+     */
+    Charger* findCharger ( chargerID_t chargerID );
 
+    /**
+     * @brief Freeze the topology: number the Chargers densely, in chargerID order, and build
+     * chargerIndex and denseChargers.
+     * Runs once the [Stations] section is done, at the first availability report. Lookups from
+     * then on are an O(1) probe and an array index, instead of a walk down the chargers tree.
+     *
+     * Only Chargers are numbered: they're looked up once per availability report, which is nearly
+     * every line of a data file. Stations are looked up once per Charger, while the [Stations]
+     * section is read; after that they're only ever walked in station ID order (the report
+     * factory, UptimeIndex, IncrementalUptime) or binary searched in vectors already in that order
+     * (ReportServer's STATION query, UptimeIndex). A station index would have nothing to speed up.
+     */
+    void freezeTopology();
+
+    /**
+     * @brief Report that the input data file couldn't be opened and throw.
+     * Prints ERROR to stdout and an explanation to stderr. See Spec Section 2.3.1 and 2.3.2.
+     * Throws std::filesystem::filesystem_error.
+     *
+     * @param inputFile The path to the input data file
+     * @param ec the reason, if known
+     */
+    [[noreturn]] static void failToOpen ( const ::std::filesystem::path& inputFile, ::std::error_code ec = {} );
+
+    /**
+     * @brief Where the Stations, Chargers and their events are allocated. A copy of this network
+     * gets an arena, and Stations and Chargers, of its own.
+     */
+    NetworkArena arena;
 
     map<stationID_t, shared_ptr<Station>> stations;
     map<chargerID_t, shared_ptr<Charger>> chargers;
     //unique_ptr<StationAvailabilityReport> report {nullptr};
     StationAvailabilityReport report;
 
+    /**
+     * @brief chargerID to dense index, see freezeTopology(). Stale while topologyFrozen is false.
+     */
+    DenseIdMap chargerIndex;
+    /**
+     * @brief The Charger each chargerID resolves to, by dense index. Owned by chargers.
+     */
+    vector<Charger*> denseChargers;
+    bool topologyFrozen {false};
+
+    /**
+     * @brief Passed on to every Charger created. See EventCoalescing.
+     */
+    EventCoalescing coalescing {EventCoalescing::NONE};
+
+    /**
+     * @brief Index for windowed reports, built on first use.
+     */
+    mutable UptimeIndex::Cache uptimeIndex;
+
+    /**
+     * @brief Maintained uptime totals, from the first addAvailabilityEvent() on.
+     */
+    std::optional<IncrementalUptime> incrementalUptime;
+
     /**
      * @brief The heading in the data file preceding the info on stations.
      * After this heading is the list of stations and their associated chargers.
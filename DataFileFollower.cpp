@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "DataFileFollower.h"
+#include "MappedFile.h"
+#include "ParallelFor.h"
+
+#include <cerrno>
+#include <fstream>
+#include <system_error>
+
+namespace Charging {
+
+DataFileFollower::DataFileFollower ( const std::filesystem::path& inputFile, unsigned threadCount )
+    : inputFile {inputFile}, threadCount {resolveThreadCount ( threadCount )} {
+    this->reload();
+}
+
+struct stat DataFileFollower::statFile() const {
+    struct stat status {};
+    if ( ::stat ( this->inputFile.c_str(), &status ) != 0 )
+        ChargingNetwork::failToOpen ( this->inputFile, std::error_code ( errno, std::generic_category() ) );
+    return status;
+}
+
+void DataFileFollower::reload() {
+    //before opening: if the file is replaced in between, the next poll sees a new inode and reads it again
+    const struct stat status = this->statFile();
+    this->device = status.st_dev;
+    this->inode = status.st_ino;
+    MappedFile mappedFile;
+    try {
+        mappedFile = MappedFile ( this->inputFile );
+    } catch ( const std::filesystem::filesystem_error& ex ) {
+        ChargingNetwork::failToOpen ( this->inputFile, ex.code() );
+    }
+    //up to and including the last newline; a partial last line waits for the next poll
+    std::string_view bytes = mappedFile.view();
+    bytes = bytes.substr ( 0, bytes.rfind ( '\n' ) + 1 ); //npos + 1 is 0
+
+    this->network = ChargingNetwork();
+    this->section = ( this->threadCount > 1 ) ? this->network.parseParallel ( bytes, this->threadCount )
+                                              : this->network.parse ( bytes );
+    this->offset = bytes.size();
+}
+
+bool DataFileFollower::poll() {
+    const struct stat status = this->statFile();
+    const std::uint64_t size = static_cast<std::uint64_t> ( status.st_size );
+    //replaced, however big the new file is, or truncated
+    if ( status.st_dev != this->device or status.st_ino != this->inode or size < this->offset ) {
+        this->reload();
+        return true;
+    }
+    if ( size == this->offset )
+        return false;
+
+    std::ifstream ifs {this->inputFile, std::ios::binary};
+    if ( not ifs.is_open() )
+        ChargingNetwork::failToOpen ( this->inputFile );
+    ifs.seekg ( static_cast<std::streamoff> ( this->offset ) );
+    this->buffer.resize ( size - this->offset );
+    ifs.read ( this->buffer.data(), static_cast<std::streamsize> ( this->buffer.size() ) );
+    this->buffer.resize ( static_cast<std::size_t> ( ifs.gcount() ) );
+
+    const auto lastNewline = this->buffer.rfind ( '\n' );
+    if ( lastNewline == std::string::npos ) //still in the middle of the first line
+        return false;
+    std::string_view bytes {this->buffer.data(), lastNewline + 1};
+    this->offset += bytes.size();
+
+    bool changed = false;
+    std::string_view line;
+    while ( DataFileParser::nextLine ( bytes, line ) ) {
+        changed |= this->followLine ( line );
+    }
+    return changed;
+}
+
+bool DataFileFollower::followLine ( std::string_view line ) {
+    if ( line.empty() or DataFileParser::isHeader ( line, this->section ) )
+        return false;
+    if ( this->section != DataFileParser::Section::AVAILABILITY_REPORTS ) //the topology is fixed
+        return false;
+    DataFileParser::AvailabilityRecord record;
+    if ( not DataFileParser::parseAvailabilityLine ( line, record ) )
+        return false;
+    return this->network.addAvailabilityEvent ( record.chargerID, record.startTime, record.endTime, record.available );
+}
+
+} //namespace Charging
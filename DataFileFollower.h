@@ -0,0 +1,121 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+#ifndef DATAFILEFOLLOWER_H
+#define DATAFILEFOLLOWER_H
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+#include <sys/stat.h>
+
+#include "ChargingNetwork.h"
+#include "DataFileParser.h"
+
+namespace Charging {
+
+/**
+ * @brief Keeps a ChargingNetwork up to date with an input data file that is still being
+ * written to, like <code>tail -f</code>.
+ *
+ * The constructor reads the file as it is. After that, each poll() reads only the bytes appended
+ * since the last one and adds their availability reports with
+ * ChargingNetwork::addAvailabilityEvent(), so the cost of a poll is the size of what was
+ * appended, not of the file.
+ *
+ *      DataFileFollower follower {"/path/to/data/file"};
+ *      cout << follower.getNetwork().getStationAvailabilityReport();
+ *      while ( ... ) {
+ *          if ( follower.poll() )
+ *              cout << follower.getNetwork().getStationAvailabilityReport();
+ *      }
+ *
+ * Only complete lines are read: a line the writer is still in the middle of is left for the next
+ * poll, so getOffset() is always the start of a line.
+ * The topology is fixed once the file has been read: [Stations] lines appended later are
+ * skipped, as are reports for chargerID's which aren't in it.
+ * A file which is replaced by another one (a different device and inode: log rotation, or a new
+ * file renamed over it) or which shrinks (truncated) is read again from the start.
+ */
+class DataFileFollower
+{
+public:
+    /**
+     * @brief Constructor. Reads every complete line the file has so far.
+     * Throws std::filesystem::filesystem_error if the file can't be opened.
+     *
+     * @param inputFile The path to the input data file. Must be a regular file.
+     * @param threadCount Number of threads to parse the file on at first, as for
+     * ChargingNetwork::IngestionEngine::PARALLEL. Polls are parsed on the calling thread.
+     */
+    explicit DataFileFollower ( const std::filesystem::path& inputFile, unsigned threadCount = 1 );
+
+    /**
+     * @brief Read whatever complete lines were appended since the last poll.
+     * Throws std::filesystem::filesystem_error if the file can't be opened any more.
+     *
+     * @return true if the network changed
+     */
+    bool poll();
+
+    /**
+     * @brief The network, with every report read so far.
+     *
+     * @return const ChargingNetwork&
+     */
+    const ChargingNetwork& getNetwork() const noexcept { return this->network; }
+
+    /**
+     * @brief Number of bytes of the file read so far.
+     *
+     * @return std::uint64_t
+     */
+    std::uint64_t getOffset() const noexcept { return this->offset; }
+
+protected:
+    /**
+     * @brief Read the file from the start into a new network.
+     */
+    void reload();
+
+    /**
+     * @brief stat() the file.
+     * Throws std::filesystem::filesystem_error if it can't be.
+     */
+    struct stat statFile() const;
+
+    /**
+     * @brief Handle one appended line.
+     *
+     * @param line the line, without its newline
+     * @return true if it added an availability report
+     */
+    bool followLine ( std::string_view line );
+
+    std::filesystem::path inputFile;
+    unsigned threadCount {1};
+    ChargingNetwork network;
+    /**
+     * @brief Bytes of the file read so far. Always just past a newline, or 0.
+     */
+    std::uint64_t offset {0};
+    /**
+     * @brief Device and inode of the file read, to tell when it's been replaced.
+     */
+    dev_t device {0};
+    ino_t inode {0};
+    /**
+     * @brief The section the last line read is in.
+     */
+    DataFileParser::Section section {DataFileParser::Section::NONE};
+    /**
+     * @brief Appended bytes, reused from poll to poll.
+     */
+    std::string buffer;
+};
+
+} //namespace Charging
+
+#endif // DATAFILEFOLLOWER_H
@@ -0,0 +1,228 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+#ifndef DATAFILEPARSER_H
+#define DATAFILEPARSER_H
+
+#include <charconv>
+#include <string_view>
+#include <system_error>
+
+#include "AvailabilityEvent.h"
+#include "Charger.h"
+#include "Station.h"
+
+namespace Charging {
+using ChargingNodes::chargerID_t;
+using ChargingNodes::stationID_t;
+using Availability::nanoseconds_t;
+
+/**
+ * @brief Tokenizer for the input data file which works directly on raw bytes.
+ * See Spec Section 2.1.
+ *
+ * Nothing here allocates: lines and tokens are string_view's into the caller's buffer
+ * (normally a MappedFile), and integers are converted with std::from_chars.
+ * The rules follow what <code>istringstream >></code> did for us before: tokens are separated
+ * by any run of whitespace (so tabs and a trailing '\\r' are fine, see input_3.txt), and a
+ * line which doesn't start with the expected numbers is ignored.
+ *
+ *      std::string_view bytes = mappedFile.view();
+ *      std::string_view line;
+ *      while ( DataFileParser::nextLine ( bytes, line ) ) {
+ *          DataFileParser::AvailabilityRecord record;
+ *          if ( DataFileParser::parseAvailabilityLine ( line, record ) )
+ *              ...
+ *      }
+ *
+ */
+class DataFileParser
+{
+public:
+    /**
+     * @brief Which section of the data file a line belongs to.
+     * NONE until the first header is seen.
+     */
+    enum class Section { NONE, STATIONS, AVAILABILITY_REPORTS };
+
+    /**
+     * @brief One parsed line of the [Charger Availability Reports] section.
+     * See Spec Section 2.1.4 and 2.1.7 to 2.1.9.
+     */
+    struct AvailabilityRecord {
+        chargerID_t chargerID {0};
+        nanoseconds_t startTime {0};
+        nanoseconds_t endTime {0};
+        bool available {false};
+    };
+
+    /**
+     * @brief The heading in the data file preceding the info on stations.
+     */
+    inline static constexpr std::string_view STATIONS_HEADER {"[Stations]"};
+    /**
+     * @brief The heading in the data file preceding the charger availability reports.
+     */
+    inline static constexpr std::string_view CHARGERAVAILABILITY_HEADER {"[Charger Availability Reports]"};
+
+    /**
+     * @brief Split the next line off the front of remaining.
+     * The line doesn't include the '\\n'. The last line of the buffer doesn't need a newline.
+     *
+     * @param remaining bytes not yet consumed. Advanced past the returned line.
+     * @param line set to the next line
+     * @return false once remaining is exhausted
+     */
+    static bool nextLine ( std::string_view& remaining, std::string_view& line ) noexcept {
+        if ( remaining.empty() )
+            return false;
+        const auto newline = remaining.find ( '\n' );
+        if ( newline == std::string_view::npos ) {
+            line = remaining;
+            remaining = {};
+        } else {
+            line = remaining.substr ( 0, newline );
+            remaining.remove_prefix ( newline + 1 );
+        }
+        return true;
+    }
+
+    /**
+     * @brief If line is a section header, return its Section.
+     * Headers must match exactly, as they did with the ifstream reader.
+     *
+     * @param line the line to check
+     * @param section set to the header's section if line is a header
+     * @return true if line is a header
+     */
+    static bool isHeader ( std::string_view line, Section& section ) noexcept {
+        if ( line.empty() or line.front() != '[' )
+            return false;
+        if ( line == STATIONS_HEADER ) {
+            section = Section::STATIONS;
+            return true;
+        }
+        if ( line == CHARGERAVAILABILITY_HEADER ) {
+            section = Section::AVAILABILITY_REPORTS;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Parse a [Charger Availability Reports] line, e.g. "1001 0 50000 true".
+     * The availability is true only for the token "true". See Spec Section 2.1.9.
+     * startTime greater than endTime is passed through as is; see clampEndTime().
+     *
+     * @param line the line to parse
+     * @param record filled in from the line
+     * @return false if the charger ID, start time or end time is missing or isn't a number
+     */
+    static bool parseAvailabilityLine ( std::string_view line, AvailabilityRecord& record ) noexcept {
+        const char* p = line.data();
+        const char* const end = p + line.size();
+        if ( not parseNumber ( p, end, record.chargerID ) )
+            return false;
+        if ( not parseNumber ( p, end, record.startTime ) )
+            return false;
+        if ( not parseNumber ( p, end, record.endTime ) )
+            return false;
+        record.available = ( nextToken ( p, end ) == "true" );
+        return true;
+    }
+
+    /**
+     * @brief Parse just the charger ID at the start of a [Charger Availability Reports] line.
+     *
+     * @param line the line to parse
+     * @param chargerID set to the charger ID
+     * @return false if the line doesn't start with a number
+     */
+    static bool parseChargerID ( std::string_view line, chargerID_t& chargerID ) noexcept {
+        const char* p = line.data();
+        return parseNumber ( p, p + line.size(), chargerID );
+    }
+
+    /**
+     * @brief Handle a reported period which ends before it starts.
+     * If startTime is greater than endTime, endTime is set to startTime. See Spec Section 4.3.
+     *
+     * @param startTime start of the reported period
+     * @param endTime end of the reported period. Adjusted if need be.
+     */
+    static void clampEndTime ( nanoseconds_t startTime, nanoseconds_t& endTime ) noexcept {
+        if ( startTime > endTime )
+            endTime = startTime;
+    }
+
+    /**
+     * @brief Parse a [Stations] line, e.g. "0 1001 1002".
+     * Calls onCharger(chargerID) for each charger ID following the station ID, stopping at the
+     * first token which isn't a number.
+     *
+     * @param line the line to parse
+     * @param stationID set to the station ID
+     * @param onCharger callable taking a chargerID_t
+     * @return false if the line doesn't start with a station ID
+     */
+    template<typename ChargerCallback>
+    static bool parseStationsLine ( std::string_view line, stationID_t& stationID, ChargerCallback&& onCharger ) {
+        const char* p = line.data();
+        const char* const end = p + line.size();
+        if ( not parseNumber ( p, end, stationID ) )
+            return false;
+        chargerID_t chargerID;
+        while ( parseNumber ( p, end, chargerID ) ) {
+            onCharger ( chargerID );
+        }
+        return true;
+    }
+
+protected:
+    /**
+     * @brief Same set of characters std::isspace() accepts in the "C" locale.
+     */
+    static constexpr bool isSpace ( char c ) noexcept {
+        return c == ' ' or c == '\t' or c == '\n' or c == '\v' or c == '\f' or c == '\r';
+    }
+
+    /**
+     * @brief Skip whitespace, then parse an unsigned integer token.
+     *
+     * @param p current position. Advanced past the number on success.
+     * @param end end of the line
+     * @param value set to the number on success
+     * @return false if there is no number, or it doesn't fit in T
+     */
+    template<typename T>
+    static bool parseNumber ( const char*& p, const char* end, T& value ) noexcept {
+        while ( p != end and isSpace ( *p ) )
+            ++p;
+        const auto [ptr, ec] = std::from_chars ( p, end, value );
+        if ( ec != std::errc() )
+            return false;
+        p = ptr;
+        return true;
+    }
+
+    /**
+     * @brief Skip whitespace, then return the following run of non-whitespace characters.
+     *
+     * @param p current position. Advanced past the token.
+     * @param end end of the line
+     * @return std::string_view the token, empty if there is none
+     */
+    static std::string_view nextToken ( const char*& p, const char* end ) noexcept {
+        while ( p != end and isSpace ( *p ) )
+            ++p;
+        const char* const start = p;
+        while ( p != end and not isSpace ( *p ) )
+            ++p;
+        return {start, static_cast<std::size_t> ( p - start )};
+    }
+};
+
+} //namespace Charging
+
+#endif // DATAFILEPARSER_H
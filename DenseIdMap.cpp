@@ -0,0 +1,48 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "DenseIdMap.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace Charging {
+
+DenseIdMap::DenseIdMap() = default;
+
+DenseIdMap::DenseIdMap ( std::span<const uint32_t> ids ) {
+    if ( ids.empty() )
+        return;
+
+    //A flat table is worth it up to a quarter full: 8 bytes a slot is still only 32 per ID.
+    static constexpr std::size_t MAX_DIRECT_SPREAD {4};
+    const auto [minID, maxID] = std::ranges::minmax ( ids );
+    const std::size_t range = std::size_t {maxID} - minID + 1;
+    this->direct = ( range <= MAX_DIRECT_SPREAD * ids.size() );
+
+    if ( this->direct ) {
+        this->minID = minID;
+        this->slots.resize ( range );
+    } else {
+        //at most half full, so probe sequences stay short
+        const std::size_t capacity = std::bit_ceil ( ids.size() * 2 );
+        this->slots.resize ( capacity );
+        this->mask = capacity - 1;
+        this->shift = 32 - std::countr_zero ( capacity );
+    }
+
+    for ( uint32_t i = 0; i < ids.size(); ++i ) {
+        const uint32_t id = ids[i];
+        std::size_t slot = this->direct ? id - this->minID : this->hash ( id );
+        if ( not this->direct ) {
+            while ( this->slots[slot].index != NOT_FOUND and this->slots[slot].id != id )
+                slot = ( slot + 1 ) & this->mask;
+        }
+        if ( this->slots[slot].index == NOT_FOUND ) { //the first index wins
+            this->slots[slot] = {id, i};
+            ++this->count;
+        }
+    }
+}
+
+} //namespace Charging
@@ -0,0 +1,105 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+#ifndef DENSEIDMAP_H
+#define DENSEIDMAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Charging {
+
+/**
+ * @brief Translates external IDs to dense indices 0 to size() - 1, in the order the IDs were
+ * given. Built once, when the topology is frozen; read-only after that. Used for chargerID_t,
+ * which every availability report is looked up by; see ChargingNetwork::freezeTopology().
+ *
+ * Lookups are O(1) and touch one or two cache lines:
+ * - if the IDs are compact (their range is at most a few times their count, as with the
+ *   consecutive IDs of the sample files), a flat table indexed by ID minus the smallest ID;
+ * - otherwise an open-addressing hash table with linear probing, kept at most half full, with
+ *   keys and indices side by side.
+ *
+ *      DenseIdMap index {chargerIDs};
+ *      const uint32_t i = index.find ( 1001 );
+ *      if ( i != DenseIdMap::NOT_FOUND )
+ *          denseChargers[i]->...
+ *
+ * Safe to read from several threads at once.
+ */
+class DenseIdMap
+{
+public:
+    /**
+     * @brief What find() returns for an ID which isn't in the map.
+     */
+    static constexpr uint32_t NOT_FOUND {UINT32_MAX};
+
+    /**
+     * Default constructor. Maps nothing.
+     */
+    DenseIdMap();
+
+    /**
+     * @brief Constructor. ids[i] maps to i. If an ID appears more than once, its first index wins.
+     *
+     * @param ids the external IDs, fewer than NOT_FOUND of them
+     */
+    explicit DenseIdMap ( std::span<const uint32_t> ids );
+
+    /**
+     * @brief The dense index of an ID.
+     *
+     * @param id the external ID
+     * @return uint32_t its index, or NOT_FOUND
+     */
+    uint32_t find ( uint32_t id ) const noexcept {
+        if ( this->direct ) {
+            const uint32_t offset = id - this->minID; //wraps for id < minID, so one compare does
+            return ( offset < this->slots.size() ) ? this->slots[offset].index : NOT_FOUND;
+        }
+        for ( std::size_t slot = this->hash ( id );; slot = ( slot + 1 ) & this->mask ) {
+            const Slot& s = this->slots[slot];
+            if ( s.index == NOT_FOUND or s.id == id )
+                return s.index;
+        }
+    }
+
+    /**
+     * @brief Number of distinct IDs.
+     *
+     * @return std::size_t
+     */
+    std::size_t size() const noexcept { return this->count; }
+
+protected:
+    struct Slot {
+        uint32_t id {0};
+        uint32_t index {NOT_FOUND};
+    };
+
+    /**
+     * @brief Fibonacci hashing: the top bits of id times 2^32 / golden ratio.
+     */
+    std::size_t hash ( uint32_t id ) const noexcept {
+        return static_cast<uint32_t> ( id * 0x9E3779B9u ) >> this->shift;
+    }
+
+    /**
+     * @brief The table: indexed by id - minID if direct, else by hash(id) and probing.
+     * Empty slots have index NOT_FOUND.
+     */
+    std::vector<Slot> slots;
+    bool direct {true};
+    uint32_t minID {0};
+    std::size_t mask {0};
+    unsigned shift {32};
+    std::size_t count {0};
+};
+
+} //namespace Charging
+
+#endif // DENSEIDMAP_H
@@ -0,0 +1,63 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "IncrementalUptime.h"
+#include "SortedRunMerger.h"
+#include "StationAvailabilityEntry.h"
+#include "StationAvailabilityReportFactory.h"
+
+#include <algorithm>
+
+namespace Availability {
+
+IncrementalUptime::IncrementalUptime() = default;
+
+IncrementalUptime::IncrementalUptime ( const map<ChargingNodes::stationID_t, shared_ptr<ChargingNodes::Station>>& stations,
+                                       const map<ChargingNodes::chargerID_t, shared_ptr<ChargingNodes::Charger>>& chargers ) {
+    this->stations.reserve ( stations.size() );
+    std::vector<ChargingNodes::chargerID_t> chargerIDs;
+    for ( const auto& [stationID, station] : stations ) {
+        StationUptime& uptime = this->stations.emplace_back();
+        uptime.stationID = stationID;
+        SortedRunMerger merger;
+        for ( const auto& charger : station->chargers ) {
+            merger.addRun ( charger->availabilityEvents );
+            //only the Charger its chargerID resolves to gets new events
+            const auto resolved = chargers.find ( charger->chargerID );
+            if ( resolved != chargers.end() and resolved->second == charger ) {
+                chargerIDs.push_back ( charger->chargerID );
+                this->chargerStations.push_back ( static_cast<uint32_t> ( this->stations.size() - 1 ) );
+            }
+        }
+        uptime.earliestStartTime = merger.earliestStartTime();
+        uptime.latestEndTime = merger.latestEndTime();
+        for ( const auto& interval : merger.mergedIntervals() ) {
+            uptime.available.insert ( interval.startTime, interval.endTime );
+        }
+    }
+    this->chargerIndex = Charging::DenseIdMap ( chargerIDs );
+}
+
+bool IncrementalUptime::insert ( ChargingNodes::chargerID_t chargerID, nanoseconds_t startTime, nanoseconds_t endTime, bool available ) {
+    const uint32_t charger = this->chargerIndex.find ( chargerID );
+    if ( charger == Charging::DenseIdMap::NOT_FOUND )
+        return false;
+    StationUptime& uptime = this->stations[this->chargerStations[charger]];
+    uptime.earliestStartTime = std::min ( uptime.earliestStartTime, startTime );
+    uptime.latestEndTime = std::max ( uptime.latestEndTime, endTime );
+    if ( available ) //downtime only counts towards the denominator
+        uptime.available.insert ( startTime, endTime );
+    return true;
+}
+
+StationAvailabilityReport IncrementalUptime::getReport() const {
+    StationAvailabilityReport report;
+    for ( const auto& uptime : this->stations ) { //in station ID order. See Spec Section 2.3.9
+        const nanoseconds_t denominator = uptime.latestEndTime - uptime.earliestStartTime;
+        report += StationAvailabilityEntry ( uptime.stationID,
+            StationAvailabilityReportFactory::uptimeFraction ( uptime.available.coveredLength(), denominator ) );
+    }
+    return report;
+}
+
+} //namespace Availability
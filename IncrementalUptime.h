@@ -0,0 +1,108 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+#ifndef INCREMENTALUPTIME_H
+#define INCREMENTALUPTIME_H
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "AvailabilityEvent.h"
+#include "Charger.h"
+#include "DenseIdMap.h"
+#include "IntervalUnion.h"
+#include "Station.h"
+#include "StationAvailabilityReport.h"
+
+namespace Availability {
+using std::shared_ptr;
+using std::map;
+
+/**
+ * @brief Keeps every Station's uptime up to date as new AvailabilityEvent's arrive.
+ * See Spec Section 2.3.
+ *
+ * Per Station it holds the numerator and denominator of the uptime fraction in maintained form:
+ * an IntervalUnion of the available time, and the earliest start and latest end time. Adding an
+ * event updates its Station's union in O(log n) and the span in O(1); getReport() then only
+ * divides, one Station at a time. The report is exactly the one StationAvailabilityReportFactory
+ * computes from scratch for the same events.
+ *
+ *      IncrementalUptime uptime {stations, chargers};   //one full pass
+ *      uptime.insert ( 1001, startTime, endTime, true );
+ *      cout << uptime.getReport();
+ *
+ * Events go to the Station of the Charger their chargerID resolves to in chargers, as in
+ * ChargingNetwork. Adding them to the Charger itself is up to the caller.
+ */
+class IncrementalUptime
+{
+public:
+    /**
+     * Default constructor. Tracks no Stations.
+     */
+    IncrementalUptime();
+
+    /**
+     * @brief Constructor. Takes in every event the Stations have so far.
+     *
+     * @param stations the Stations, keyed by station ID
+     * @param chargers the Charger each chargerID resolves to
+     */
+    IncrementalUptime ( const map<ChargingNodes::stationID_t, shared_ptr<ChargingNodes::Station>>& stations,
+                        const map<ChargingNodes::chargerID_t, shared_ptr<ChargingNodes::Charger>>& chargers );
+
+    /**
+     * @brief Take in one new event. O(log n) in the number of disjoint available intervals of
+     * its Station.
+     *
+     * @param chargerID the Charger which reported
+     * @param startTime start of the reported period
+     * @param endTime end of the reported period, not before startTime
+     * @param available whether the Charger was available for the period
+     * @return false if chargerID isn't a Charger of any Station
+     */
+    bool insert ( ChargingNodes::chargerID_t chargerID, nanoseconds_t startTime, nanoseconds_t endTime, bool available );
+
+    /**
+     * @brief The report for every event taken in so far, in station ID order.
+     *
+     * @return StationAvailabilityReport
+     */
+    StationAvailabilityReport getReport() const;
+
+protected:
+    /**
+     * @brief The maintained numerator and denominator of one Station.
+     */
+    struct StationUptime {
+        ChargingNodes::stationID_t stationID {0};
+        /**
+         * @brief Union of the time any Charger at the Station was available.
+         */
+        IntervalUnion available;
+        nanoseconds_t earliestStartTime {UINT64_MAX};
+        nanoseconds_t latestEndTime {0};
+    };
+
+    /**
+     * @brief Per Station, in station ID order so the report comes out in order.
+     */
+    std::vector<StationUptime> stations;
+
+    /**
+     * @brief chargerID to dense index into chargerStations.
+     */
+    Charging::DenseIdMap chargerIndex;
+
+    /**
+     * @brief Index into stations of the Station each Charger reports for, by dense index.
+     */
+    std::vector<uint32_t> chargerStations;
+};
+
+} //namespace Availability
+
+#endif // INCREMENTALUPTIME_H
@@ -0,0 +1,104 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "IntervalSort.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <span>
+
+namespace Availability {
+
+void IntervalSort::sort ( std::vector<Interval>& intervals, Algorithm algorithm ) {
+    if ( algorithm == Algorithm::RADIX and intervals.size() >= RADIX_THRESHOLD )
+        radixSort ( intervals );
+    else
+        std::ranges::sort ( intervals );
+}
+
+void IntervalSort::sort ( std::vector<AvailabilityEvent>& events, Algorithm algorithm ) {
+    if ( algorithm != Algorithm::RADIX or events.size() < RADIX_THRESHOLD ) {
+        std::ranges::sort ( events, std::less() );
+        return;
+    }
+    std::vector<Interval> intervals;
+    intervals.reserve ( events.size() );
+    for ( const auto& ae : events ) {
+        intervals.push_back ( {ae.startTime, ae.endTime} );
+    }
+    radixSort ( intervals );
+    for ( std::size_t i = 0; i < events.size(); ++i ) {
+        events[i].startTime = intervals[i].startTime;
+        events[i].endTime = intervals[i].endTime;
+    }
+}
+
+void IntervalSort::radixSort ( std::vector<Interval>& intervals ) {
+    const std::size_t n = intervals.size();
+    if ( n < 2 )
+        return;
+
+    //For a given start time, ordering by end time is ordering by duration, and durations span a
+    //far narrower range than end times. So the key is (start - minStart) : duration, which needs
+    //fewer digits than start : end.
+    nanoseconds_t minStart {UINT64_MAX}, maxStart {0};
+    nanoseconds_t minDuration {UINT64_MAX}, maxDuration {0};
+    for ( const auto& interval : intervals ) {
+        minStart = std::min ( minStart, interval.startTime );
+        maxStart = std::max ( maxStart, interval.startTime );
+        minDuration = std::min ( minDuration, interval.endTime - interval.startTime );
+        maxDuration = std::max ( maxDuration, interval.endTime - interval.startTime );
+    }
+
+    //Only the digits which aren't zero for every key get a pass
+    auto digitsFor = [] ( uint64_t maxKey ) {
+        std::size_t digits {0};
+        for ( ; maxKey != 0; maxKey >>= DIGIT_BITS )
+            ++digits;
+        return digits;
+    };
+    const std::size_t durationDigits = digitsFor ( maxDuration - minDuration );
+    const std::size_t passes = durationDigits + digitsFor ( maxStart - minStart );
+    if ( passes == 0 ) //all the same
+        return;
+
+    //Pass p sorts on digit p of the key, least significant first: the duration digits, then the
+    //start time digits. All the histograms are counted in a single read of the intervals.
+    auto digit = [=] ( const Interval& interval, std::size_t pass ) {
+        const uint64_t key = ( pass < durationDigits ) ? interval.endTime - interval.startTime - minDuration
+                                                       : interval.startTime - minStart;
+        const std::size_t shift = DIGIT_BITS * ( pass < durationDigits ? pass : pass - durationDigits );
+        return static_cast<std::size_t> ( ( key >> shift ) & ( BUCKETS - 1 ) );
+    };
+    std::vector<std::size_t> counts ( passes * BUCKETS, 0 );
+    for ( const auto& interval : intervals ) {
+        for ( std::size_t pass = 0; pass < passes; ++pass )
+            ++counts[pass * BUCKETS + digit ( interval, pass )];
+    }
+
+    std::vector<Interval> scratch ( n );
+    std::vector<Interval>* from = &intervals;
+    std::vector<Interval>* to = &scratch;
+    for ( std::size_t pass = 0; pass < passes; ++pass ) {
+        const auto histogram = std::span {counts}.subspan ( pass * BUCKETS, BUCKETS );
+        //every interval in one bucket: this pass wouldn't move anything
+        if ( std::ranges::find ( histogram, n ) != histogram.end() )
+            continue;
+
+        std::size_t offset {0};
+        for ( auto& count : histogram ) {
+            const std::size_t bucketSize = count;
+            count = offset;
+            offset += bucketSize;
+        }
+        for ( const auto& interval : *from ) {
+            ( *to ) [histogram[digit ( interval, pass )]++] = interval;
+        }
+        std::swap ( from, to );
+    }
+    if ( from != &intervals )
+        intervals.swap ( scratch );
+}
+
+} //namespace Availability
@@ -0,0 +1,99 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+#ifndef INTERVALSORT_H
+#define INTERVALSORT_H
+
+#include "AvailabilityEvent.h"
+
+#include <compare>
+#include <cstddef>
+#include <vector>
+
+namespace Availability {
+
+/**
+ * @brief Sorts time intervals by start time, then end time.
+ *
+ * Sorting is the expensive step whenever a Station's events have to be put in order (see
+ * StationAvailabilityReportFactory::UptimeEngine). Two algorithms are offered so they can be
+ * compared on real data:
+ *
+ * COMPARISON is std::ranges::sort.
+ *
+ * RADIX is an LSD radix sort, 11 bits per pass: the digits of the duration, then those of the
+ * start time, least significant first. (For equal start times, ordering by duration is ordering
+ * by end time.) Each pass is a stable counting scatter between the intervals and a scratch
+ * buffer, so it costs O(n) per pass rather than O(n log n) comparisons. Keys are taken relative
+ * to the smallest start time and duration, so a batch spanning a narrow range of time has no
+ * high digits to sort on, and those passes are skipped, as is any pass in which every interval
+ * falls into the same bucket. A day of events in nanoseconds needs 5 passes on the start time,
+ * not 6, and durations under a second 3 more.
+ *
+ * Intervals are sorted as compact 16-byte Interval's, not as AvailabilityEvent's. RADIX needs
+ * endTime >= startTime, which DataFileParser::clampEndTime() guarantees for parsed events.
+ *
+ *      vector<IntervalSort::Interval> intervals = ...;
+ *      IntervalSort::sort ( intervals, IntervalSort::Algorithm::RADIX );
+ */
+class IntervalSort
+{
+public:
+    /**
+     * @brief Which sort to use. Both give the same order.
+     */
+    enum class Algorithm { COMPARISON, RADIX };
+
+    /**
+     * @brief A time interval, [startTime, endTime).
+     */
+    struct Interval {
+        nanoseconds_t startTime;
+        nanoseconds_t endTime;
+
+        auto operator<=> ( const Interval& other ) const = default;
+    };
+
+    /**
+     * @brief Sort intervals by start time, then end time.
+     *
+     * @param intervals the intervals to sort, in place
+     * @param algorithm the sort to use
+     */
+    static void sort ( std::vector<Interval>& intervals, Algorithm algorithm );
+
+    /**
+     * @brief Sort AvailabilityEvent's as operator<=> orders them, which for events that are
+     * all available (or all not) is by start time, then end time.
+     * With RADIX, the events are sorted as Interval's and written back.
+     *
+     * @param events the events to sort, in place. Must all have the same available flag.
+     * @param algorithm the sort to use
+     */
+    static void sort ( std::vector<AvailabilityEvent>& events, Algorithm algorithm );
+
+protected:
+    /**
+     * @brief LSD radix sort. See IntervalSort.
+     *
+     * @param intervals the intervals to sort, in place
+     */
+    static void radixSort ( std::vector<Interval>& intervals );
+
+    /**
+     * @brief Below this many intervals the passes cost more than they save, and
+     * std::ranges::sort is used anyway.
+     */
+    static constexpr std::size_t RADIX_THRESHOLD {256};
+
+    /**
+     * @brief Bits sorted on per pass. 2048 buckets of counts still fit in L1 cache.
+     */
+    static constexpr std::size_t DIGIT_BITS {11};
+    static constexpr std::size_t BUCKETS {std::size_t {1} << DIGIT_BITS};
+};
+
+} //namespace Availability
+
+#endif // INTERVALSORT_H
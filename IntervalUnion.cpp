@@ -0,0 +1,62 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "IntervalUnion.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace Availability {
+
+IntervalUnion::IntervalUnion() = default;
+
+IntervalUnion::IntervalUnion ( const IntervalUnion& other ) = default;
+
+IntervalUnion::IntervalUnion ( IntervalUnion&& other ) noexcept = default;
+
+IntervalUnion::~IntervalUnion() = default;
+
+IntervalUnion& IntervalUnion::operator= ( const IntervalUnion& other ) = default;
+
+IntervalUnion& IntervalUnion::operator= ( IntervalUnion&& other ) noexcept = default;
+
+bool IntervalUnion::operator== ( const IntervalUnion& other ) const {
+    return this->intervals == other.intervals;
+}
+
+void IntervalUnion::insert ( nanoseconds_t startTime, nanoseconds_t endTime ) {
+    if ( startTime >= endTime )
+        return;
+
+    //it: the first interval starting after startTime
+    auto it = this->intervals.upper_bound ( startTime );
+
+    //The interval before it starts at or before startTime. If it reaches startTime, we extend it.
+    if ( it != this->intervals.begin() ) {
+        const auto previous = std::prev ( it );
+        if ( previous->second >= startTime ) {
+            if ( previous->second >= endTime )
+                return; //already covered
+            startTime = previous->first;
+            this->covered -= previous->second - previous->first;
+            it = this->intervals.erase ( previous );
+        }
+    }
+
+    //Swallow every interval which starts inside (or right at the end of) the new one
+    while ( it != this->intervals.end() and it->first <= endTime ) {
+        endTime = std::max ( endTime, it->second );
+        this->covered -= it->second - it->first;
+        it = this->intervals.erase ( it );
+    }
+
+    this->intervals.emplace_hint ( it, startTime, endTime );
+    this->covered += endTime - startTime;
+}
+
+void IntervalUnion::clear() noexcept {
+    this->intervals.clear();
+    this->covered = 0;
+}
+
+} //namespace Availability
@@ -0,0 +1,134 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+#ifndef INTERVALUNION_H
+#define INTERVALUNION_H
+
+#include "AvailabilityEvent.h"
+
+#include <cstddef>
+#include <map>
+
+namespace Availability {
+
+/**
+ * @brief The union of a set of time intervals, kept as disjoint intervals plus their total length.
+ * Intervals are half-open, [startTime, endTime), like AvailabilityEvent's. Inserting an interval
+ * merges it with every interval it overlaps or touches, so the union is always stored in its
+ * smallest form and coveredLength() is the numerator of the uptime fraction (see Spec Section 2.3)
+ * without any sorting or overlap removal afterwards.
+ *
+ * Inserting is O(log n) in the number of disjoint intervals, plus the number of intervals it
+ * swallows. Memory depends on how many gaps there are, not on how many intervals went in.
+ *
+ *      IntervalUnion u;
+ *      u.insert ( 0, 100 );
+ *      u.insert ( 50, 150 );
+ *      u.insert ( 200, 300 );
+ *      u.coveredLength();  // 250
+ *      u.size();           // 2: [0, 150) and [200, 300)
+ */
+class IntervalUnion
+{
+public:
+    using const_iterator = std::map<nanoseconds_t, nanoseconds_t>::const_iterator;
+
+    /**
+     * Default constructor. C++ default.
+     */
+    IntervalUnion();
+
+    /**
+     * Copy constructor. C++ default.
+     *
+     * @param other object to copy
+     */
+    IntervalUnion ( const IntervalUnion& other );
+
+    /**
+     * @brief Move constructor. C++ default.
+     *
+     * @param other The object to be moved from
+     */
+    IntervalUnion ( IntervalUnion&& other ) noexcept;
+
+    /**
+     * Destructor. C++ default.
+     */
+    ~IntervalUnion();
+
+    /**
+     * Assignment operator. C++ default.
+     *
+     * @param other object to copy from
+     * @return object reference
+     */
+    IntervalUnion& operator= ( const IntervalUnion& other );
+
+    /**
+     * @brief Move assignment operator. C++ default.
+     *
+     * @param other The object to be moved from
+     * @return IntervalUnion&
+     */
+    IntervalUnion& operator= ( IntervalUnion&& other ) noexcept;
+
+    /**
+     * @brief Equality operator.
+     *
+     * @param other the object being compared with
+     * @return true if both cover exactly the same time
+     */
+    bool operator== ( const IntervalUnion& other ) const;
+
+    /**
+     * @brief Add [startTime, endTime) to the union. Empty intervals are ignored.
+     *
+     * @param startTime start of the interval
+     * @param endTime end of the interval
+     */
+    void insert ( nanoseconds_t startTime, nanoseconds_t endTime );
+
+    /**
+     * @brief Remove all intervals.
+     */
+    void clear() noexcept;
+
+    /**
+     * @brief Total length of the time covered.
+     *
+     * @return nanoseconds_t
+     */
+    nanoseconds_t coveredLength() const noexcept { return covered; }
+
+    /**
+     * @brief Number of disjoint intervals making up the union.
+     *
+     * @return std::size_t
+     */
+    std::size_t size() const noexcept { return intervals.size(); }
+
+    bool empty() const noexcept { return intervals.empty(); }
+
+    /**
+     * @brief Iterate the disjoint intervals in time order, as (startTime, endTime) pairs.
+     */
+    const_iterator begin() const noexcept { return intervals.begin(); }
+    const_iterator end() const noexcept { return intervals.end(); }
+
+protected:
+    /**
+     * @brief The disjoint intervals: endTime keyed by startTime.
+     * No two intervals overlap or touch.
+     */
+    std::map<nanoseconds_t, nanoseconds_t> intervals;
+    /**
+     * @brief Sum of the lengths of intervals.
+     */
+    nanoseconds_t covered {0};
+};
+
+} //namespace Availability
+
+#endif // INTERVALUNION_H
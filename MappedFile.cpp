@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "MappedFile.h"
+
+#include <cerrno>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Charging {
+
+MappedFile::MappedFile() = default;
+
+MappedFile::MappedFile ( const std::filesystem::path& file ) {
+    const int fd = ::open ( file.c_str(), O_RDONLY | O_CLOEXEC );
+    if ( fd < 0 ) {
+        throw std::filesystem::filesystem_error ( "Could not open file.", file,
+                                                  std::error_code ( errno, std::generic_category() ) );
+    }
+
+    struct stat st {};
+    if ( ::fstat ( fd, &st ) != 0 ) {
+        const int error = errno;
+        ::close ( fd );
+        throw std::filesystem::filesystem_error ( "Could not stat file.", file,
+                                                  std::error_code ( error, std::generic_category() ) );
+    }
+
+    //mmap() refuses a zero length, and an empty file has nothing to parse anyway
+    if ( st.st_size > 0 ) {
+        void* mapped = ::mmap ( nullptr, static_cast<std::size_t> ( st.st_size ), PROT_READ, MAP_PRIVATE, fd, 0 );
+        if ( mapped == MAP_FAILED ) {
+            const int error = errno;
+            ::close ( fd );
+            throw std::filesystem::filesystem_error ( "Could not map file.", file,
+                                                      std::error_code ( error, std::generic_category() ) );
+        }
+        this->data = mapped;
+        this->size = static_cast<std::size_t> ( st.st_size );
+        //we read front to back, once. Let the kernel read ahead aggressively.
+        ::madvise ( this->data, this->size, MADV_SEQUENTIAL );
+    }
+
+    //the mapping keeps its own reference to the file
+    ::close ( fd );
+}
+
+MappedFile::~MappedFile() {
+    this->unmap();
+}
+
+MappedFile::MappedFile ( MappedFile&& other ) noexcept :
+    data {std::exchange ( other.data, nullptr )}, size {std::exchange ( other.size, 0 )} {
+}
+
+MappedFile& MappedFile::operator= ( MappedFile&& other ) noexcept {
+    if ( this != &other ) {
+        this->unmap();
+        this->data = std::exchange ( other.data, nullptr );
+        this->size = std::exchange ( other.size, 0 );
+    }
+    return *this;
+}
+
+void MappedFile::unmap() noexcept {
+    if ( this->data != nullptr ) {
+        ::munmap ( this->data, this->size );
+        this->data = nullptr;
+        this->size = 0;
+    }
+}
+
+} //namespace Charging
@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+
+namespace Charging {
+
+/**
+ * @brief Read-only memory mapping of a whole file.
+ * The mapping lives as long as the object. The bytes are exposed as a string_view so the
+ * parsers can walk them in place, without copying a line into a string first.
+ *
+ *      MappedFile mf {"/path/to/data/file"};
+ *      std::string_view bytes = mf.view();
+ *
+ * Throws std::filesystem::filesystem_error if the file can't be opened or mapped.
+ * An empty file is not mapped at all and yields an empty view.
+ * Move-only, since two objects must not unmap the same region.
+ */
+class MappedFile
+{
+public:
+    /**
+     * Default constructor. Maps nothing.
+     */
+    MappedFile();
+
+    /**
+     * @brief Constructor. Maps the whole of the file read-only.
+     *
+     * @param file path of the file to map
+     */
+    explicit MappedFile ( const std::filesystem::path& file );
+
+    /**
+     * Destructor. Unmaps the file.
+     */
+    ~MappedFile();
+
+    MappedFile ( const MappedFile& other ) = delete;
+    MappedFile& operator= ( const MappedFile& other ) = delete;
+
+    /**
+     * @brief Move constructor. The moved-from object maps nothing afterwards.
+     *
+     * @param other The object to be moved from
+     */
+    MappedFile ( MappedFile&& other ) noexcept;
+
+    /**
+     * @brief Move assignment operator. Unmaps whatever this object mapped before.
+     *
+     * @param other The object to be moved from
+     * @return MappedFile&
+     */
+    MappedFile& operator= ( MappedFile&& other ) noexcept;
+
+    /**
+     * @brief The mapped bytes.
+     *
+     * @return std::string_view
+     */
+    std::string_view view() const noexcept {
+        return {static_cast<const char*>(this->data), this->size};
+    }
+
+protected:
+    /**
+     * @brief Unmap the current region, if any.
+     */
+    void unmap() noexcept;
+
+    /**
+     * @brief Start of the mapped region, or nullptr if nothing is mapped.
+     */
+    void* data {nullptr};
+    /**
+     * @brief Length of the mapped region in bytes.
+     */
+    std::size_t size {0};
+};
+
+} //namespace Charging
+
+#endif // MAPPEDFILE_H
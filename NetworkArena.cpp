@@ -0,0 +1,17 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "NetworkArena.h"
+
+namespace Charging {
+
+NetworkArena::NetworkArena() : arena {std::make_shared<std::pmr::monotonic_buffer_resource> ( INITIAL_SIZE )} {
+}
+
+NetworkArena::NetworkArena ( const NetworkArena& other ) = default;
+
+NetworkArena& NetworkArena::operator= ( const NetworkArena& other ) = default;
+
+NetworkArena::~NetworkArena() = default;
+
+} //namespace Charging
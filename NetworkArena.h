@@ -0,0 +1,113 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+#ifndef NETWORKARENA_H
+#define NETWORKARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+
+namespace Charging {
+
+/**
+ * @brief The memory a ChargingNetwork's object graph lives in: one std::pmr::monotonic_buffer_resource.
+ *
+ * Stations and Chargers are allocated from it with makeShared(), and each Charger's event
+ * columns grow in it thru resource(). Allocating is a pointer bump into a few large buffers
+ * rather than a trip to malloc per object and per column growth; freeing is a no-op, and the
+ * buffers go back all at once when the last owner of the arena is gone.
+ *
+ *      NetworkArena arena;
+ *      auto charger = arena.makeShared<Charger> ( chargerID, arena.resource() );
+ *
+ * Every object made by makeShared() keeps the arena alive, so a Charger can safely outlive its
+ * ChargingNetwork. Copies of a NetworkArena share the same arena.
+ * Like the monotonic_buffer_resource underneath, an arena isn't safe to allocate from on several
+ * threads at once.
+ */
+class NetworkArena
+{
+public:
+    /**
+     * @brief Allocator for std::allocate_shared which allocates from the arena and keeps it
+     * alive. Deallocating is a no-op until the arena goes.
+     */
+    template<typename T>
+    struct Allocator {
+        using value_type = T;
+
+        explicit Allocator ( std::shared_ptr<std::pmr::memory_resource> arena ) noexcept : arena {std::move ( arena )} {}
+        template<typename U>
+        Allocator ( const Allocator<U>& other ) noexcept : arena {other.arena} {}
+
+        T* allocate ( std::size_t n ) {
+            return static_cast<T*> ( this->arena->allocate ( n * sizeof ( T ), alignof ( T ) ) );
+        }
+        void deallocate ( T* p, std::size_t n ) noexcept {
+            this->arena->deallocate ( p, n * sizeof ( T ), alignof ( T ) );
+        }
+        template<typename U>
+        bool operator== ( const Allocator<U>& other ) const noexcept { return this->arena == other.arena; }
+
+        std::shared_ptr<std::pmr::memory_resource> arena;
+    };
+
+    /**
+     * @brief Size of the arena's first buffer. Each one after that is bigger.
+     */
+    static constexpr std::size_t INITIAL_SIZE {64 * 1024};
+
+    /**
+     * Default constructor. A new, empty arena. Nothing is allocated until it's used.
+     */
+    NetworkArena();
+
+    /**
+     * Copy constructor. The copy shares the arena.
+     *
+     * @param other the object being copied from
+     */
+    NetworkArena ( const NetworkArena& other );
+
+    /**
+     * Assignment operator. This object shares other's arena afterwards.
+     *
+     * @param other the object being copied from
+     * @return NetworkArena&
+     */
+    NetworkArena& operator= ( const NetworkArena& other );
+
+    /**
+     * Destructor. The arena goes once nothing made from it is left.
+     */
+    ~NetworkArena();
+
+    /**
+     * @brief The arena, for std::pmr containers.
+     * Containers using it don't keep it alive; something made by makeShared() has to own them.
+     *
+     * @return std::pmr::memory_resource*
+     */
+    std::pmr::memory_resource* resource() const noexcept { return this->arena.get(); }
+
+    /**
+     * @brief std::make_shared, allocating the object and its control block from the arena.
+     *
+     * @param args the arguments to T's constructor
+     * @return std::shared_ptr<T>
+     */
+    template<typename T, typename... Args>
+    std::shared_ptr<T> makeShared ( Args&&... args ) const {
+        return std::allocate_shared<T> ( Allocator<T> {this->arena}, std::forward<Args> ( args )... );
+    }
+
+protected:
+    std::shared_ptr<std::pmr::memory_resource> arena;
+};
+
+} //namespace Charging
+
+#endif // NETWORKARENA_H
@@ -0,0 +1,212 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "NetworkSnapshot.h"
+#include "MappedFile.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Charging {
+
+namespace {
+
+/**
+ * @brief The bytes of a contiguous range of trivially copyable objects.
+ */
+template<typename T>
+std::span<const std::byte> bytesOf ( std::span<const T> objects ) {
+    return std::as_bytes ( objects );
+}
+
+/**
+ * @brief Number of words holding the available flags of count events.
+ */
+constexpr uint64_t bitWordsFor ( uint64_t count ) {
+    return ( count + 63 ) / 64;
+}
+
+} //namespace
+
+void NetworkSnapshot::Checksum::add ( std::span<const std::byte> bytes ) noexcept {
+    const std::size_t count = bytes.size() / sizeof ( uint64_t );
+    for ( std::size_t i = 0; i < count; ++i ) {
+        uint64_t word;
+        std::memcpy ( &word, bytes.data() + i * sizeof word, sizeof word );
+        auto& lane = this->lanes[( this->words + i ) & 3];
+        lane = ( lane ^ word ) * PRIME;
+    }
+    this->words += count;
+}
+
+uint64_t NetworkSnapshot::Checksum::value() const noexcept {
+    uint64_t result {this->words};
+    for ( const uint64_t lane : this->lanes ) {
+        result = ( result ^ lane ) * PRIME;
+        result ^= result >> 29;
+    }
+    return result;
+}
+
+void NetworkSnapshot::save ( const ChargingNetwork& network, const std::filesystem::path& snapshotFile ) {
+    //Lay out the tables first; the columns follow in the same Charger order.
+    std::vector<StationEntry> stationTable;
+    std::vector<ChargerEntry> chargerTable;
+    std::vector<const AvailabilityEventStore*> columns;
+    uint64_t eventCount {0};
+    uint64_t bitWordCount {0};
+
+    stationTable.reserve ( network.stations.size() );
+    for ( const auto& [stationID, station] : network.stations ) {
+        stationTable.push_back ( {stationID, static_cast<uint32_t> ( station->chargers.size() )} );
+        for ( const auto& charger : station->chargers ) {
+            const auto resolved = network.chargers.find ( charger->chargerID );
+            const bool isResolved = resolved != network.chargers.end() and resolved->second == charger;
+            const auto& events = charger->availabilityEvents;
+            chargerTable.push_back ( {charger->chargerID, isResolved ? RESOLVED_CHARGER : 0, eventCount, events.size(), bitWordCount} );
+            columns.push_back ( &events );
+            eventCount += events.size();
+            bitWordCount += bitWordsFor ( events.size() );
+        }
+    }
+
+    Header header {};
+    std::memcpy ( header.magic, MAGIC, sizeof MAGIC );
+    header.version = VERSION;
+    header.headerSize = sizeof ( Header );
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.stationCount = stationTable.size();
+    header.chargerCount = chargerTable.size();
+    header.eventCount = eventCount;
+    header.bitWordCount = bitWordCount;
+
+    std::filesystem::path partialFile {snapshotFile};
+    partialFile += ".partial";
+    errno = 0;
+    std::ofstream ofs {partialFile, std::ios::binary | std::ios::trunc};
+    if ( !ofs.is_open() ) //open() leaves the reason, e.g. a missing directory, in errno
+        throw std::filesystem::filesystem_error ( "Could not write snapshot.", snapshotFile,
+                                                  errno != 0 ? std::error_code ( errno, std::generic_category() )
+                                                             : std::make_error_code ( std::errc::io_error ) );
+
+    Checksum checksum;
+    auto write = [&] ( std::span<const std::byte> bytes ) {
+        checksum.add ( bytes );
+        ofs.write ( reinterpret_cast<const char*> ( bytes.data() ), static_cast<std::streamsize> ( bytes.size() ) );
+    };
+
+    //the header is written again once the checksum is known
+    ofs.write ( reinterpret_cast<const char*> ( &header ), sizeof header );
+    write ( bytesOf ( std::span<const StationEntry> {stationTable} ) );
+    write ( bytesOf ( std::span<const ChargerEntry> {chargerTable} ) );
+    for ( const auto* events : columns )
+        write ( bytesOf ( events->startTimes() ) );
+    for ( const auto* events : columns )
+        write ( bytesOf ( events->endTimes() ) );
+    for ( const auto* events : columns )
+        write ( bytesOf ( events->availableWords().first ( bitWordsFor ( events->size() ) ) ) );
+
+    header.checksum = checksum.value();
+    ofs.seekp ( 0 );
+    ofs.write ( reinterpret_cast<const char*> ( &header ), sizeof header );
+    ofs.close();
+    if ( !ofs ) {
+        std::error_code ignored;
+        std::filesystem::remove ( partialFile, ignored );
+        throw std::filesystem::filesystem_error ( "Could not write snapshot.", snapshotFile,
+                                                  std::make_error_code ( std::errc::io_error ) );
+    }
+    std::filesystem::rename ( partialFile, snapshotFile );
+}
+
+ChargingNetwork NetworkSnapshot::load ( const std::filesystem::path& snapshotFile, Verification verification ) {
+    std::shared_ptr<const MappedFile> mapping;
+    try {
+        mapping = std::make_shared<const MappedFile> ( snapshotFile );
+    } catch ( const std::filesystem::filesystem_error& ex ) {
+        ChargingNetwork::failToOpen ( snapshotFile, ex.code() );
+    }
+    const std::string_view bytes = mapping->view();
+    auto corrupt = [&] ( const std::string& reason ) { //reported as ChargingNetwork reports a bad data file
+        std::cout << ChargingNetwork::ERROR_TEXT << "\n"; // See Spec Section 2.3.1
+        std::cerr << "Invalid snapshot: " << reason << "\n"; // See Spec Section 2.3.2
+        return std::runtime_error ( snapshotFile.string() + ": " + reason );
+    };
+
+    Header header;
+    if ( bytes.size() < sizeof header )
+        throw corrupt ( "not a snapshot" );
+    std::memcpy ( &header, bytes.data(), sizeof header );
+    if ( std::memcmp ( header.magic, MAGIC, sizeof MAGIC ) != 0 )
+        throw corrupt ( "not a snapshot" );
+    if ( header.byteOrder != BYTE_ORDER_MARK )
+        throw corrupt ( "snapshot was written on a machine of another byte order" );
+    if ( header.version != VERSION or header.headerSize != sizeof header )
+        throw corrupt ( "unsupported snapshot version " + std::to_string ( header.version ) );
+
+    //Size check, without letting a corrupt count overflow the arithmetic
+    const uint64_t payloadSize = bytes.size() - sizeof header;
+    const uint64_t maxWords = payloadSize / sizeof ( uint64_t );
+    if ( header.stationCount > maxWords or header.chargerCount > maxWords / 4
+        or header.eventCount > maxWords / 2 or header.bitWordCount > maxWords
+        or header.stationCount * sizeof ( StationEntry ) + header.chargerCount * sizeof ( ChargerEntry )
+           + header.eventCount * 2 * sizeof ( uint64_t ) + header.bitWordCount * sizeof ( uint64_t ) != payloadSize )
+        throw corrupt ( "snapshot is truncated or has trailing data" );
+
+    const std::byte* const payload = reinterpret_cast<const std::byte*> ( bytes.data() ) + sizeof header;
+    if ( verification == Verification::FULL ) {
+        Checksum checksum;
+        checksum.add ( {payload, payloadSize} );
+        if ( checksum.value() != header.checksum )
+            throw corrupt ( "snapshot checksum mismatch" );
+    }
+
+    //The mapping is page aligned and every part of the file is 8-byte aligned within it
+    const auto* const stationTable = reinterpret_cast<const StationEntry*> ( payload );
+    const auto* const chargerTable = reinterpret_cast<const ChargerEntry*> ( stationTable + header.stationCount );
+    const auto* const startTimes = reinterpret_cast<const nanoseconds_t*> ( chargerTable + header.chargerCount );
+    const auto* const endTimes = startTimes + header.eventCount;
+    const auto* const availableWords = reinterpret_cast<const uint64_t*> ( endTimes + header.eventCount );
+
+    ChargingNetwork network;
+    uint64_t chargerIndex {0};
+    for ( uint64_t s = 0; s < header.stationCount; ++s ) {
+        const StationEntry& stationEntry = stationTable[s];
+        if ( stationEntry.chargerCount > header.chargerCount - chargerIndex )
+            throw corrupt ( "station " + std::to_string ( stationEntry.stationID ) + " lists too many chargers" );
+        auto station = std::make_shared<Station> ( stationEntry.stationID );
+        for ( uint32_t c = 0; c < stationEntry.chargerCount; ++c ) {
+            const ChargerEntry& chargerEntry = chargerTable[chargerIndex++];
+            if ( chargerEntry.eventOffset > header.eventCount
+                or chargerEntry.eventCount > header.eventCount - chargerEntry.eventOffset
+                or chargerEntry.bitWordOffset > header.bitWordCount
+                or bitWordsFor ( chargerEntry.eventCount ) > header.bitWordCount - chargerEntry.bitWordOffset )
+                throw corrupt ( "charger " + std::to_string ( chargerEntry.chargerID ) + " has events outside the snapshot" );
+
+            auto charger = std::make_shared<Charger> ( chargerEntry.chargerID );
+            if ( chargerEntry.eventCount > 0 ) {
+                charger->availabilityEvents = AvailabilityEventStore::borrow (
+                    {startTimes + chargerEntry.eventOffset, chargerEntry.eventCount},
+                    {endTimes + chargerEntry.eventOffset, chargerEntry.eventCount},
+                    {availableWords + chargerEntry.bitWordOffset, bitWordsFor ( chargerEntry.eventCount )},
+                    mapping );
+            }
+            if ( chargerEntry.flags & RESOLVED_CHARGER )
+                network.chargers.insert ( {chargerEntry.chargerID, charger} );
+            station->insertCharger ( charger );
+        }
+        network.stations.insert ( {stationEntry.stationID, station} );
+    }
+    if ( chargerIndex != header.chargerCount )
+        throw corrupt ( "charger table doesn't match the stations" );
+
+    return network;
+}
+
+} //namespace Charging
@@ -0,0 +1,166 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+#ifndef NETWORKSNAPSHOT_H
+#define NETWORKSNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+#include "ChargingNetwork.h"
+
+namespace Charging {
+
+/**
+ * @brief Saves a parsed ChargingNetwork to a binary snapshot file, and loads it back.
+ *
+ * Parsing a large input data file means tokenizing every line of it. A snapshot stores the
+ * result instead: the Stations, the Chargers of each Station, which of them the chargerID's
+ * resolve to, and each Charger's AvailabilityEventStore columns, exactly as they are in memory.
+ * Loading memory-maps the snapshot and the Chargers borrow their columns straight from the
+ * mapping (see AvailabilityEventStore::borrow()), so nothing is parsed or copied. The mapping
+ * stays alive for as long as any Charger loaded from it.
+ *
+ *      ChargingNetwork cn {"/path/to/data/file"};
+ *      NetworkSnapshot::save ( cn, "/path/to/snapshot" );
+ *      ...
+ *      ChargingNetwork loaded = NetworkSnapshot::load ( "/path/to/snapshot" );
+ *      cout << loaded.getStationAvailabilityReport();
+ *
+ * File layout, all integers in native byte order, every part 8-byte aligned:
+ *
+ *      Header              64 bytes, see Header
+ *      station table       stationCount x StationEntry, in station ID order
+ *      charger table       chargerCount x ChargerEntry, each Station's Chargers in turn
+ *      start times         eventCount x uint64_t
+ *      end times           eventCount x uint64_t
+ *      available flags     bitWordCount x uint64_t, each Charger's flags starting on a new word
+ *
+ * The checksum covers everything after the header. load() prints ERROR and throws
+ * std::runtime_error for a file which isn't a snapshot, is of another version or byte order, is
+ * truncated, or is corrupt.
+ */
+class NetworkSnapshot
+{
+public:
+    /**
+     * @brief How much load() checks before it trusts a snapshot.
+     * FULL verifies the checksum, which reads the whole file once.
+     * STRUCTURE only checks the header and that every table entry is within the file, so loading
+     * touches no more than the tables.
+     */
+    enum class Verification { FULL, STRUCTURE };
+
+    /**
+     * @brief Snapshot format version. Bump when the layout changes.
+     */
+    static constexpr uint32_t VERSION {1};
+
+    /**
+     * @brief Write a snapshot of a ChargingNetwork.
+     * The snapshot is written next to snapshotFile and renamed over it once complete, so a reader
+     * never sees half a snapshot.
+     * Throws std::filesystem::filesystem_error if the file can't be written.
+     *
+     * @param network the ChargingNetwork to save
+     * @param snapshotFile where to write the snapshot
+     */
+    static void save ( const ChargingNetwork& network, const std::filesystem::path& snapshotFile );
+
+    /**
+     * @brief Load a snapshot written by save().
+     * Throws std::filesystem::filesystem_error if the file can't be opened, and
+     * std::runtime_error if it isn't a valid snapshot.
+     *
+     * @param snapshotFile the snapshot to load
+     * @param verification how much to check. See Verification.
+     * @return ChargingNetwork the same object graph that was saved
+     */
+    static ChargingNetwork load ( const std::filesystem::path& snapshotFile, Verification verification = Verification::FULL );
+
+protected:
+    /**
+     * @brief Start of a snapshot file.
+     */
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t headerSize;
+        uint64_t byteOrder;
+        uint64_t stationCount;
+        uint64_t chargerCount;
+        uint64_t eventCount;
+        uint64_t bitWordCount;
+        uint64_t checksum;
+    };
+
+    /**
+     * @brief One Station. Its Chargers are the next chargerCount entries of the charger table.
+     */
+    struct StationEntry {
+        uint32_t stationID;
+        uint32_t chargerCount;
+    };
+
+    /**
+     * @brief One Charger of a Station.
+     */
+    struct ChargerEntry {
+        uint32_t chargerID;
+        uint32_t flags;
+        uint64_t eventOffset;
+        uint64_t eventCount;
+        uint64_t bitWordOffset;
+    };
+
+    static_assert ( sizeof ( Header ) == 64 and sizeof ( StationEntry ) == 8 and sizeof ( ChargerEntry ) == 32 );
+
+    /**
+     * @brief ChargerEntry::flags bit: this is the Charger its chargerID resolves to.
+     * A chargerID listed more than once only resolves to the first Charger created for it; the
+     * others stay in their Station without any events, as in ChargingNetwork::insertCharger().
+     */
+    static constexpr uint32_t RESOLVED_CHARGER {1};
+
+    inline static constexpr char MAGIC[8] {'E', 'L', 'E', 'C', 'S', 'N', 'A', 'P'};
+
+    /**
+     * @brief Written as is; reads back as something else on a machine of the other byte order.
+     */
+    static constexpr uint64_t BYTE_ORDER_MARK {0x0102030405060708};
+
+    /**
+     * @brief 64-bit checksum of a sequence of words.
+     * Four independent FNV-1a style lanes, so the multiplies don't wait on each other. Fed in
+     * pieces, it gives the same result as fed all at once.
+     */
+    class Checksum
+    {
+    public:
+        /**
+         * @brief Add bytes to the checksum.
+         *
+         * @param bytes a whole number of 8-byte words
+         */
+        void add ( std::span<const std::byte> bytes ) noexcept;
+
+        /**
+         * @brief The checksum of everything added so far.
+         *
+         * @return uint64_t
+         */
+        uint64_t value() const noexcept;
+
+    protected:
+        static constexpr uint64_t PRIME {0x100000001b3};
+        uint64_t lanes[4] {0xcbf29ce484222325, 0x84222325cbf29ce4, 0x9ce484222325cbf2, 0x2325cbf29ce48422};
+        std::size_t words {0};
+    };
+};
+
+} //namespace Charging
+
+#endif // NETWORKSNAPSHOT_H
@@ -0,0 +1,44 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+#ifndef OPTIONPARSING_H
+#define OPTIONPARSING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+namespace Charging {
+
+/**
+ * @brief Parse a command line option's value as a whole, non negative decimal number, for
+ * electra2 and its tools.
+ * std::stoull on its own takes "-5" as 2^64 - 5 and stops quietly at "4x", and narrowing what it
+ * returns to a uint32_t turns 4294967298 into 2; all three are errors here.
+ * Throws std::invalid_argument or std::out_of_range, both std::logic_error.
+ *
+ *      options.stationCount = parseUnsigned ( value, UINT32_MAX );
+ *
+ * @param text the option's value
+ * @param max the largest value allowed, e.g. the largest the field it goes into can hold
+ * @return uint64_t
+ */
+inline uint64_t parseUnsigned ( const std::string& text, uint64_t max = UINT64_MAX ) {
+    if ( text.starts_with ( '-' ) )
+        throw std::out_of_range ( text );
+    if ( text.empty() or text.front() < '0' or text.front() > '9' ) //stoull skips leading spaces, and a "-" after them
+        throw std::invalid_argument ( text );
+    std::size_t end {0};
+    const uint64_t value = std::stoull ( text, &end );
+    if ( end != text.size() )
+        throw std::invalid_argument ( text );
+    if ( value > max )
+        throw std::out_of_range ( text );
+    return value;
+}
+
+} //namespace Charging
+
+#endif // OPTIONPARSING_H
@@ -0,0 +1,93 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+#ifndef PARALLELFOR_H
+#define PARALLELFOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Charging {
+
+/**
+ * @brief Most threads resolveThreadCount() allows per hardware thread. Past a few, more threads
+ * only add switching; far past, starting them fails.
+ */
+inline constexpr unsigned MAX_THREADS_PER_CORE {8};
+
+/**
+ * @brief Resolve a requested thread count. 0 means one thread per hardware thread.
+ * Clamped to MAX_THREADS_PER_CORE per hardware thread, and never below 64 so a small machine can
+ * still be asked for a test's worth of threads.
+ *
+ * @param requested the thread count asked for
+ * @return unsigned at least 1
+ */
+inline unsigned resolveThreadCount ( unsigned requested ) noexcept {
+    const unsigned cores = std::max ( std::thread::hardware_concurrency(), 1u );
+    if ( requested == 0 )
+        requested = cores;
+    return std::clamp ( requested, 1u, std::max ( cores * MAX_THREADS_PER_CORE, 64u ) );
+}
+
+/**
+ * @brief Call work(i) for every i in [0, count) on up to threadCount threads.
+ * Indices are handed out one at a time from a shared counter, so a thread which drew a cheap
+ * index goes back for another rather than idling while a slow one finishes. Callers who want
+ * the big items started first should order them that way.
+ * The calling thread is one of the workers. If work throws, the remaining indices are skipped
+ * and the first exception is rethrown here once all threads have stopped.
+ *
+ *      parallelFor ( chunks.size(), 8, [&] ( std::size_t i ) { parseChunk ( chunks[i] ); } );
+ *
+ * @param count number of work items
+ * @param threadCount maximum number of threads, 0 for one per hardware thread
+ * @param work callable taking a std::size_t index
+ */
+template<typename Work>
+void parallelFor ( std::size_t count, unsigned threadCount, Work&& work ) {
+    const std::size_t threads = std::min<std::size_t> ( resolveThreadCount ( threadCount ), count );
+    if ( threads <= 1 ) {
+        for ( std::size_t i = 0; i < count; ++i )
+            work ( i );
+        return;
+    }
+
+    std::atomic<std::size_t> next {0};
+    std::exception_ptr firstError;
+    std::mutex errorMutex;
+
+    auto worker = [&] () {
+        for ( std::size_t i = next++; i < count; i = next++ ) {
+            try {
+                work ( i );
+            } catch ( ... ) {
+                std::lock_guard lock {errorMutex};
+                if ( not firstError )
+                    firstError = std::current_exception();
+                next = count; //stop handing out work
+            }
+        }
+    };
+
+    {
+        std::vector<std::jthread> pool;
+        pool.reserve ( threads - 1 );
+        for ( std::size_t t = 1; t < threads; ++t )
+            pool.emplace_back ( worker );
+        worker();
+    } //jthread joins here
+
+    if ( firstError )
+        std::rethrow_exception ( firstError );
+}
+
+} //namespace Charging
+
+#endif // PARALLELFOR_H
@@ -0,0 +1,104 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "ReportClient.h"
+
+#include <cerrno>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace Charging {
+
+ReportClient::ReportClient ( const std::filesystem::path& socketPath ) {
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+    const std::string path = socketPath.string();
+    if ( path.size() >= sizeof address.sun_path )
+        throw std::system_error ( std::make_error_code ( std::errc::filename_too_long ), "Socket path too long: " + path );
+    std::memcpy ( address.sun_path, path.c_str(), path.size() + 1 );
+
+    this->fd = ::socket ( AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0 );
+    if ( this->fd < 0 )
+        throw std::system_error ( errno, std::system_category(), "socket" );
+    if ( ::connect ( this->fd, reinterpret_cast<const sockaddr*> ( &address ), sizeof address ) < 0 ) {
+        const int error = errno;
+        ::close ( this->fd );
+        throw std::system_error ( error, std::system_category(), "Could not connect to " + path );
+    }
+}
+
+ReportClient::~ReportClient() {
+    if ( this->fd >= 0 )
+        ::close ( this->fd );
+}
+
+ReportClient::ReportClient ( ReportClient&& other ) noexcept
+    : fd {std::exchange ( other.fd, -1 )}, response {std::move ( other.response )} {
+}
+
+ReportProtocol::Status ReportClient::call ( const std::vector<std::byte>& request ) {
+    if ( not ReportProtocol::writeFrame ( this->fd, request )
+         or not ReportProtocol::readFrame ( this->fd, this->response, UINT32_MAX ) )
+        throw std::system_error ( std::make_error_code ( std::errc::connection_aborted ), "The report server hung up" );
+    std::span<const std::byte> rest {this->response};
+    ReportProtocol::Status status;
+    if ( not ReportProtocol::get ( rest, status ) )
+        throw std::runtime_error ( "Empty response from the report server" );
+    this->response.erase ( this->response.begin() );
+    if ( status != ReportProtocol::Status::OK and status != ReportProtocol::Status::NOT_FOUND and status != ReportProtocol::Status::FAILED )
+        throw std::runtime_error ( "The report server rejected the request" );
+    return status;
+}
+
+StationAvailabilityReport ReportClient::getReport() {
+    std::vector<std::byte> request;
+    ReportProtocol::put ( request, ReportProtocol::Opcode::REPORT );
+    if ( this->call ( request ) != ReportProtocol::Status::OK )
+        throw std::runtime_error ( "The report server couldn't produce the report" );
+
+    StationAvailabilityReport report;
+    std::span<const std::byte> rest {this->response};
+    uint32_t stationID;
+    float uptime;
+    while ( ReportProtocol::get ( rest, stationID ) and ReportProtocol::get ( rest, uptime ) ) {
+        report += StationAvailabilityEntry ( stationID, uptime );
+    }
+    return report;
+}
+
+std::optional<float> ReportClient::getUptime ( ReportProtocol::Opcode opcode, uint32_t id ) {
+    std::vector<std::byte> request;
+    ReportProtocol::put ( request, opcode );
+    ReportProtocol::put ( request, id );
+    if ( this->call ( request ) != ReportProtocol::Status::OK )
+        return std::nullopt;
+    std::span<const std::byte> rest {this->response};
+    float uptime;
+    if ( not ReportProtocol::get ( rest, uptime ) )
+        throw std::runtime_error ( "Short response from the report server" );
+    return uptime;
+}
+
+std::optional<float> ReportClient::getStationUptime ( ChargingNodes::stationID_t stationID ) {
+    return this->getUptime ( ReportProtocol::Opcode::STATION, stationID );
+}
+
+std::optional<float> ReportClient::getChargerUptime ( ChargingNodes::chargerID_t chargerID ) {
+    return this->getUptime ( ReportProtocol::Opcode::CHARGER, chargerID );
+}
+
+bool ReportClient::reload() {
+    std::vector<std::byte> request;
+    ReportProtocol::put ( request, ReportProtocol::Opcode::RELOAD );
+    return this->call ( request ) == ReportProtocol::Status::OK;
+}
+
+} //namespace Charging
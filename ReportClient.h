@@ -0,0 +1,107 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+#ifndef REPORTCLIENT_H
+#define REPORTCLIENT_H
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+#include "Charger.h"
+#include "ReportProtocol.h"
+#include "Station.h"
+#include "StationAvailabilityReport.h"
+
+namespace Charging {
+
+/**
+ * @brief Queries a ReportServer over its Unix domain socket. See ReportProtocol.
+ *
+ *      ReportClient client {"/run/electra2.sock"};
+ *      cout << client.getReport();
+ *      std::optional<float> uptime = client.getStationUptime ( 0 );
+ *
+ * One connection for the life of the object; requests go one at a time.
+ * Throws std::system_error if the server can't be reached or hangs up, and std::runtime_error
+ * if it answers with something other than OK or NOT_FOUND.
+ * Move-only, since two objects must not close the same socket.
+ */
+class ReportClient
+{
+public:
+    /**
+     * @brief Constructor. Connects to the server.
+     *
+     * @param socketPath the server's socket
+     */
+    explicit ReportClient ( const std::filesystem::path& socketPath );
+
+    /**
+     * Destructor. Closes the connection.
+     */
+    ~ReportClient();
+
+    ReportClient ( const ReportClient& other ) = delete;
+    ReportClient& operator= ( const ReportClient& other ) = delete;
+
+    /**
+     * @brief Move constructor. The moved-from object is not connected afterwards.
+     *
+     * @param other The object to be moved from
+     */
+    ReportClient ( ReportClient&& other ) noexcept;
+
+    /**
+     * @brief The station availability report.
+     *
+     * @return StationAvailabilityReport
+     */
+    StationAvailabilityReport getReport();
+
+    /**
+     * @brief The uptime of one Station.
+     *
+     * @param stationID the Station
+     * @return std::optional<float> nothing if there's no such Station
+     */
+    std::optional<float> getStationUptime ( ChargingNodes::stationID_t stationID );
+
+    /**
+     * @brief The uptime of one Charger, over its own reporting span.
+     *
+     * @param chargerID the Charger
+     * @return std::optional<float> nothing if there's no such Charger
+     */
+    std::optional<float> getChargerUptime ( ChargingNodes::chargerID_t chargerID );
+
+    /**
+     * @brief Have the server read its data file again.
+     *
+     * @return false if the server couldn't read it, and still has the old one
+     */
+    bool reload();
+
+protected:
+    /**
+     * @brief Send a request and read the response.
+     *
+     * @param request the request payload
+     * @return ReportProtocol::Status the status byte. response holds what follows it.
+     */
+    ReportProtocol::Status call ( const std::vector<std::byte>& request );
+
+    /**
+     * @brief Send a STATION or CHARGER request and read the uptime.
+     */
+    std::optional<float> getUptime ( ReportProtocol::Opcode opcode, uint32_t id );
+
+    int fd {-1};
+    std::vector<std::byte> response;
+};
+
+} //namespace Charging
+
+#endif // REPORTCLIENT_H
@@ -0,0 +1,58 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "ReportProtocol.h"
+
+#include <cerrno>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace Charging {
+
+namespace {
+
+bool writeAll ( int fd, const std::byte* data, std::size_t size ) {
+    while ( size > 0 ) {
+        //MSG_NOSIGNAL: a client which hung up is an error here, not a SIGPIPE
+        const ssize_t written = ::send ( fd, data, size, MSG_NOSIGNAL );
+        if ( written < 0 ) {
+            if ( errno == EINTR )
+                continue;
+            return false;
+        }
+        data += written;
+        size -= static_cast<std::size_t> ( written );
+    }
+    return true;
+}
+
+bool readAll ( int fd, std::byte* data, std::size_t size ) {
+    while ( size > 0 ) {
+        const ssize_t count = ::read ( fd, data, size );
+        if ( count < 0 and errno == EINTR )
+            continue;
+        if ( count <= 0 )
+            return false;
+        data += count;
+        size -= static_cast<std::size_t> ( count );
+    }
+    return true;
+}
+
+} //namespace
+
+bool ReportProtocol::writeFrame ( int fd, std::span<const std::byte> payload ) {
+    const uint32_t length = static_cast<uint32_t> ( payload.size() );
+    return writeAll ( fd, reinterpret_cast<const std::byte*> ( &length ), sizeof length )
+           and writeAll ( fd, payload.data(), payload.size() );
+}
+
+bool ReportProtocol::readFrame ( int fd, std::vector<std::byte>& payload, uint32_t maxSize ) {
+    uint32_t length {0};
+    if ( not readAll ( fd, reinterpret_cast<std::byte*> ( &length ), sizeof length ) or length > maxSize )
+        return false;
+    payload.resize ( length );
+    return readAll ( fd, payload.data(), length );
+}
+
+} //namespace Charging
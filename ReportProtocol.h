@@ -0,0 +1,106 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+#ifndef REPORTPROTOCOL_H
+#define REPORTPROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace Charging {
+
+/**
+ * @brief The framing ReportServer and ReportClient talk over a Unix domain socket.
+ *
+ * Every message, both ways, is one frame: a uint32_t payload length, then the payload.
+ * All integers and floats are in native byte order, since both ends are on the same machine.
+ *
+ *      request payload     uint8_t Opcode, then a uint32_t ID for STATION and CHARGER
+ *      response payload    uint8_t Status, then for OK:
+ *                              REPORT      a {uint32_t stationID, float uptime} per Station,
+ *                                          in station ID order
+ *                              STATION     float uptime
+ *                              CHARGER     float uptime
+ *                              RELOAD      nothing
+ *
+ * Uptimes are fractions, as in StationAvailabilityEntry. A connection can carry any number of
+ * requests, each answered in turn before the next is read.
+ */
+class ReportProtocol
+{
+public:
+    enum class Opcode : uint8_t {
+        REPORT = 1,     ///< the station availability report
+        STATION = 2,    ///< the uptime of one Station
+        CHARGER = 3,    ///< the uptime of one Charger, over its own reporting span
+        RELOAD = 4      ///< read the data file again
+    };
+
+    enum class Status : uint8_t {
+        OK = 0,
+        NOT_FOUND = 1,      ///< no such Station or Charger
+        BAD_REQUEST = 2,    ///< unknown opcode, or the wrong payload length for it
+        FAILED = 3          ///< the request was understood but couldn't be carried out
+    };
+
+    /**
+     * @brief Longest request payload the server reads. Longer ones close the connection.
+     */
+    static constexpr uint32_t MAX_REQUEST_SIZE {64};
+
+    /**
+     * @brief Write one frame to fd, retrying short writes.
+     *
+     * @param fd a connected socket
+     * @param payload the payload
+     * @return false if the peer went away or the write failed
+     */
+    static bool writeFrame ( int fd, std::span<const std::byte> payload );
+
+    /**
+     * @brief Read one frame from fd, retrying short reads.
+     *
+     * @param fd a connected socket
+     * @param payload set to the payload
+     * @param maxSize longest payload to accept
+     * @return false at end of stream, on a read error, or if the payload is longer than maxSize
+     */
+    static bool readFrame ( int fd, std::vector<std::byte>& payload, uint32_t maxSize );
+
+    /**
+     * @brief Append the bytes of a trivially copyable value to a payload.
+     */
+    template<typename T>
+    static void put ( std::vector<std::byte>& payload, T value ) {
+        static_assert ( std::is_trivially_copyable_v<T> );
+        const std::size_t size = payload.size();
+        payload.resize ( size + sizeof value );
+        std::memcpy ( payload.data() + size, &value, sizeof value );
+    }
+
+    /**
+     * @brief Read a trivially copyable value from the front of a payload.
+     *
+     * @param payload bytes not yet read. Advanced past the value.
+     * @param value set to the value
+     * @return false if payload is too short
+     */
+    template<typename T>
+    static bool get ( std::span<const std::byte>& payload, T& value ) noexcept {
+        static_assert ( std::is_trivially_copyable_v<T> );
+        if ( payload.size() < sizeof value )
+            return false;
+        std::memcpy ( &value, payload.data(), sizeof value );
+        payload = payload.subspan ( sizeof value );
+        return true;
+    }
+};
+
+} //namespace Charging
+
+#endif // REPORTPROTOCOL_H
@@ -0,0 +1,292 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "ReportServer.h"
+#include "ParallelFor.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <system_error>
+#include <thread>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace Charging {
+
+namespace {
+
+/**
+ * @brief How often run() looks at the stop and reload flags when no client connects.
+ */
+constexpr int POLL_INTERVAL_MS {100};
+
+/**
+ * @brief How long a worker waits on a client in one read or write. A worker only takes a
+ * connection once a request has begun to arrive, so this only cuts off clients which stall
+ * part way thru a request, or don't read the response.
+ */
+constexpr timeval IO_TIMEOUT {2, 0};
+
+[[noreturn]] void throwSocketError ( const std::string& what ) {
+    throw std::system_error ( errno, std::system_category(), what );
+}
+
+} //namespace
+
+ReportServer::ReportServer ( const std::filesystem::path& inputFile, const std::filesystem::path& socketPath,
+                             unsigned workerCount, unsigned threadCount )
+    : inputFile {inputFile}, socketPath {socketPath},
+      workerCount {resolveThreadCount ( workerCount )}, threadCount {resolveThreadCount ( threadCount )} {
+    this->loaded = this->load();
+
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+    const std::string path = socketPath.string();
+    if ( path.size() >= sizeof address.sun_path )
+        throw std::system_error ( std::make_error_code ( std::errc::filename_too_long ), "Socket path too long: " + path );
+    std::memcpy ( address.sun_path, path.c_str(), path.size() + 1 );
+
+    //A socket file is either being listened on by another server, or was left behind by one
+    //which didn't exit cleanly. Only the latter is ours to replace.
+    std::error_code ec;
+    if ( std::filesystem::is_socket ( socketPath, ec ) ) {
+        const int probe = ::socket ( AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0 );
+        if ( probe < 0 )
+            throwSocketError ( "socket" );
+        const bool listening = ( ::connect ( probe, reinterpret_cast<const sockaddr*> ( &address ), sizeof address ) == 0 );
+        const int error = errno;
+        ::close ( probe );
+        if ( listening )
+            throw std::system_error ( std::make_error_code ( std::errc::address_in_use ), "A server is already listening on " + path );
+        if ( error == ECONNREFUSED )
+            std::filesystem::remove ( socketPath, ec );
+    }
+
+    this->listenFd = ::socket ( AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0 );
+    if ( this->listenFd < 0 )
+        throwSocketError ( "socket" );
+    const bool bound = ( ::bind ( this->listenFd, reinterpret_cast<const sockaddr*> ( &address ), sizeof address ) == 0 );
+    if ( not bound or ::listen ( this->listenFd, SOMAXCONN ) < 0 ) {
+        const int error = errno;
+        ::close ( this->listenFd );
+        if ( bound )
+            std::filesystem::remove ( socketPath, ec );
+        errno = error;
+        throwSocketError ( "Could not listen on " + path );
+    }
+    this->ownsSocket = true;
+}
+
+ReportServer::~ReportServer() {
+    for ( const int fd : this->pending )
+        ::close ( fd );
+    ::close ( this->listenFd );
+    if ( this->ownsSocket ) { //never another server's
+        std::error_code ec;
+        std::filesystem::remove ( this->socketPath, ec );
+    }
+}
+
+shared_ptr<const ReportServer::Loaded> ReportServer::load() const {
+    const auto engine = ( this->threadCount > 1 ) ? ChargingNetwork::IngestionEngine::PARALLEL : ChargingNetwork::IngestionEngine::MAPPED;
+    ChargingNetwork network {this->inputFile, engine, this->threadCount};
+    StationAvailabilityReport report = network.getStationAvailabilityReport ( this->threadCount );
+    return std::make_shared<const Loaded> ( Loaded {std::move ( network ), std::move ( report )} );
+}
+
+shared_ptr<const ReportServer::Loaded> ReportServer::current() const {
+    std::lock_guard lock {this->loadedMutex};
+    return this->loaded;
+}
+
+bool ReportServer::reload() {
+    shared_ptr<const Loaded> fresh;
+    try {
+        fresh = this->load(); //outside the lock: queries go on being answered meanwhile
+    } catch ( const std::exception& ex ) {
+        std::cerr << "Could not reload " << this->inputFile << ": " << ex.what() << "\n";
+        return false;
+    }
+    std::lock_guard lock {this->loadedMutex};
+    this->loaded = std::move ( fresh );
+    return true;
+}
+
+void ReportServer::stop() noexcept {
+    this->stopping = true;
+}
+
+void ReportServer::requestReload() noexcept {
+    this->reloadRequested = true;
+}
+
+void ReportServer::run() {
+    if ( ::pipe2 ( this->wakeFds, O_CLOEXEC | O_NONBLOCK ) < 0 )
+        throwSocketError ( "pipe" );
+    {
+        std::vector<std::jthread> workers;
+        workers.reserve ( this->workerCount );
+        for ( unsigned i = 0; i < this->workerCount; ++i )
+            workers.emplace_back ( [this] { this->work(); } );
+
+        //Waits with a timeout rather than blocking in accept(), so stop() and requestReload() can
+        //just set a flag, which is all a signal handler may do.
+        //Idle connections are watched here too, and only handed to a worker once a request comes
+        //in on them, so clients which connect and send nothing don't tie the workers up.
+        std::vector<pollfd> watched;
+        while ( not this->stopping ) {
+            if ( this->reloadRequested.exchange ( false ) )
+                this->reload();
+            watched.assign ( {{this->listenFd, POLLIN, 0}, {this->wakeFds[0], POLLIN, 0}} );
+            {
+                std::lock_guard lock {this->connectionsMutex};
+                for ( const int fd : this->idle )
+                    watched.push_back ( {fd, POLLIN, 0} );
+            }
+            if ( ::poll ( watched.data(), watched.size(), POLL_INTERVAL_MS ) <= 0 ) //timeout or EINTR
+                continue;
+            if ( watched[1].revents != 0 ) { //a worker handed a connection back
+                char drained[64];
+                while ( ::read ( this->wakeFds[0], drained, sizeof drained ) > 0 ) {
+                }
+            }
+            std::size_t ready {0};
+            {
+                std::lock_guard lock {this->connectionsMutex};
+                for ( auto watch = watched.begin() + 2; watch != watched.end(); ++watch ) {
+                    if ( watch->revents == 0 ) //POLLIN, or POLLHUP or POLLERR for the worker to find
+                        continue;
+                    std::erase ( this->idle, watch->fd );
+                    this->pending.push_back ( watch->fd );
+                    ++ready;
+                }
+                if ( watched[0].revents != 0 ) {
+                    const int fd = ::accept4 ( this->listenFd, nullptr, nullptr, SOCK_CLOEXEC );
+                    if ( fd >= 0 ) {
+                        ::setsockopt ( fd, SOL_SOCKET, SO_RCVTIMEO, &IO_TIMEOUT, sizeof IO_TIMEOUT );
+                        ::setsockopt ( fd, SOL_SOCKET, SO_SNDTIMEO, &IO_TIMEOUT, sizeof IO_TIMEOUT );
+                        this->idle.push_back ( fd );
+                    }
+                }
+            }
+            for ( ; ready > 0; --ready )
+                this->connectionReady.notify_one();
+        }
+
+        {
+            std::lock_guard lock {this->connectionsMutex};
+            for ( const int fd : this->pending )
+                ::close ( fd );
+            this->pending.clear();
+            for ( const int fd : this->idle )
+                ::close ( fd );
+            this->idle.clear();
+            for ( const int fd : this->active ) //wakes the worker up from its read()
+                ::shutdown ( fd, SHUT_RDWR );
+        }
+        this->connectionReady.notify_all();
+    } //jthread joins here
+    ::close ( this->wakeFds[0] );
+    ::close ( this->wakeFds[1] );
+}
+
+void ReportServer::work() {
+    for ( ;; ) {
+        int fd;
+        {
+            std::unique_lock lock {this->connectionsMutex};
+            this->connectionReady.wait ( lock, [this] { return this->stopping or not this->pending.empty(); } );
+            if ( this->stopping )
+                return;
+            fd = this->pending.front();
+            this->pending.pop_front();
+            this->active.insert ( fd );
+        }
+        const bool open = this->serve ( fd );
+        bool handedBack {false};
+        {
+            std::lock_guard lock {this->connectionsMutex};
+            this->active.erase ( fd );
+            if ( open and not this->stopping ) { //run() watches it for the next request
+                this->idle.push_back ( fd );
+                handedBack = true;
+            }
+        }
+        if ( handedBack ) {
+            const char wake {0};
+            [[maybe_unused]] const auto written = ::write ( this->wakeFds[1], &wake, 1 ); //full is fine: run() is woken anyway
+        } else {
+            ::close ( fd );
+        }
+    }
+}
+
+bool ReportServer::serve ( int fd ) {
+    std::vector<std::byte> request;
+    std::vector<std::byte> response;
+    if ( not ReportProtocol::readFrame ( fd, request, ReportProtocol::MAX_REQUEST_SIZE ) )
+        return false;
+    this->answer ( request, response );
+    return ReportProtocol::writeFrame ( fd, response );
+}
+
+void ReportServer::answer ( std::span<const std::byte> request, std::vector<std::byte>& response ) {
+    using Opcode = ReportProtocol::Opcode;
+    using Status = ReportProtocol::Status;
+    response.clear();
+    auto status = [&response] ( Status s ) { ReportProtocol::put ( response, s ); };
+
+    uint8_t opcode {0};
+    uint32_t id {0};
+    if ( not ReportProtocol::get ( request, opcode ) )
+        return status ( Status::BAD_REQUEST );
+    //STATION and CHARGER take an ID; nothing else takes anything
+    const bool takesID = ( opcode == static_cast<uint8_t> ( Opcode::STATION ) or opcode == static_cast<uint8_t> ( Opcode::CHARGER ) );
+    if ( takesID and not ReportProtocol::get ( request, id ) )
+        return status ( Status::BAD_REQUEST );
+    if ( not request.empty() )
+        return status ( Status::BAD_REQUEST );
+
+    const auto snapshot = this->current(); //kept alive until we're done, whatever reload() does
+    switch ( static_cast<Opcode> ( opcode ) ) {
+    case Opcode::REPORT:
+        status ( Status::OK );
+        response.reserve ( 1 + snapshot->report.getEntries().size() * ( sizeof ( uint32_t ) + sizeof ( float ) ) );
+        for ( const auto& entry : snapshot->report.getEntries() ) {
+            ReportProtocol::put<uint32_t> ( response, entry.getStationID() );
+            ReportProtocol::put ( response, entry.getUptimeFraction() );
+        }
+        break;
+    case Opcode::STATION: {
+        const auto& entries = snapshot->report.getEntries(); //in station ID order
+        const auto entry = std::ranges::lower_bound ( entries, id, {}, &StationAvailabilityEntry::getStationID );
+        if ( entry == entries.end() or entry->getStationID() != id )
+            return status ( Status::NOT_FOUND );
+        status ( Status::OK );
+        ReportProtocol::put ( response, entry->getUptimeFraction() );
+    }
+        break;
+    case Opcode::CHARGER: {
+        const auto uptime = snapshot->network.getChargerUptime ( id );
+        if ( not uptime )
+            return status ( Status::NOT_FOUND );
+        status ( Status::OK );
+        ReportProtocol::put ( response, *uptime );
+    }
+        break;
+    case Opcode::RELOAD:
+        status ( this->reload() ? Status::OK : Status::FAILED );
+        break;
+    default:
+        status ( Status::BAD_REQUEST );
+        break;
+    }
+}
+
+} //namespace Charging
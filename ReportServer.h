@@ -0,0 +1,167 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+#ifndef REPORTSERVER_H
+#define REPORTSERVER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <unordered_set>
+#include <vector>
+
+#include "ChargingNetwork.h"
+#include "ReportProtocol.h"
+#include "StationAvailabilityReport.h"
+
+namespace Charging {
+
+/**
+ * @brief Keeps a ChargingNetwork in memory and answers uptime queries about it over a Unix
+ * domain socket, so a query costs a round trip instead of a process start and a full parse.
+ * See ReportProtocol for the queries and their framing, and ReportClient for the other end.
+ *
+ *      ReportServer server {"/path/to/data/file", "/run/electra2.sock"};
+ *      server.run();   //until stop()
+ *
+ * The data file is read, and the station availability report computed, up front; a REPORT or
+ * STATION query then only copies out what was computed, and a CHARGER query only looks at the
+ * events of that one Charger.
+ *
+ * Connections are accepted, and watched while idle, on the thread calling run(). When a request
+ * comes in on one it's handed to a pool of worker threads, so that many clients can be answered
+ * at once; the worker answers that one request and hands the connection back. Clients which
+ * connect and send nothing cost a file descriptor, not a worker, and one which stalls part way
+ * thru a request is cut off after a couple of seconds.
+ *
+ * reload() reads the data file again into a new ChargingNetwork and swaps it in once it's
+ * complete. Queries already being answered finish on the network they started with; if the file
+ * can't be read, the old network stays.
+ */
+class ReportServer
+{
+public:
+    /**
+     * @brief Constructor. Reads the data file, then listens on socketPath.
+     * Throws std::filesystem::filesystem_error if the data file can't be read, and
+     * std::system_error if the socket can't be set up, or another server is listening on
+     * socketPath. A stale socket file at socketPath, which nothing is listening on, is replaced.
+     *
+     * @param inputFile the input data file
+     * @param socketPath where to create the socket
+     * @param workerCount number of connections served at once. 0 means one per hardware thread.
+     * @param threadCount threads to read the data file and compute the report on, as for
+     * ChargingNetwork::IngestionEngine::PARALLEL
+     */
+    ReportServer ( const std::filesystem::path& inputFile, const std::filesystem::path& socketPath,
+                   unsigned workerCount = 0, unsigned threadCount = 1 );
+
+    /**
+     * Destructor. Closes and removes the socket, which this server created.
+     */
+    ~ReportServer();
+
+    ReportServer ( const ReportServer& other ) = delete;
+    ReportServer& operator= ( const ReportServer& other ) = delete;
+
+    /**
+     * @brief Accept and serve connections until stop() is called.
+     */
+    void run();
+
+    /**
+     * @brief Make run() return, after closing the open connections.
+     * Safe to call from a signal handler.
+     */
+    void stop() noexcept;
+
+    /**
+     * @brief Have run() reload the data file as soon as it can.
+     * Safe to call from a signal handler, e.g. for SIGHUP.
+     */
+    void requestReload() noexcept;
+
+    /**
+     * @brief Read the data file again and swap the new network in.
+     * If the file can't be read, keeps the current network and writes why to stderr. A client
+     * which asked for the reload is answered false, and prints ERROR; see ReportClient::reload().
+     *
+     * @return false if the file couldn't be read
+     */
+    bool reload();
+
+protected:
+    /**
+     * @brief Everything a query is answered from. Never changed once published.
+     */
+    struct Loaded {
+        ChargingNetwork network;
+        StationAvailabilityReport report;
+    };
+
+    /**
+     * @brief Read the data file into a new Loaded.
+     */
+    shared_ptr<const Loaded> load() const;
+
+    /**
+     * @brief The Loaded queries are answered from right now.
+     */
+    shared_ptr<const Loaded> current() const;
+
+    /**
+     * @brief Worker thread: take connections with a request waiting off the queue and serve them,
+     * until stopping.
+     */
+    void work();
+
+    /**
+     * @brief Read one request on a connection and answer it.
+     *
+     * @param fd the connection
+     * @return false if the client hung up, stalled, or sent something which isn't a request
+     */
+    bool serve ( int fd );
+
+    /**
+     * @brief Answer one request.
+     *
+     * @param request the request payload
+     * @param response set to the response payload
+     */
+    void answer ( std::span<const std::byte> request, std::vector<std::byte>& response );
+
+    std::filesystem::path inputFile;
+    std::filesystem::path socketPath;
+    unsigned workerCount {1};
+    unsigned threadCount {1};
+    int listenFd {-1};
+    bool ownsSocket {false};    ///< the socket file at socketPath is this server's, to remove
+
+    mutable std::mutex loadedMutex;
+    shared_ptr<const Loaded> loaded;
+
+    /**
+     * @brief Accepted connections: waiting for a request, which run() watches, waiting for a
+     * worker, and being served. Each is in one of them.
+     */
+    std::mutex connectionsMutex;
+    std::condition_variable connectionReady;
+    std::vector<int> idle;
+    std::deque<int> pending;
+    std::unordered_set<int> active;
+    int wakeFds[2] {-1, -1};    ///< a pipe, written to wake run() when a connection is handed back
+
+    std::atomic<bool> stopping {false};
+    std::atomic<bool> reloadRequested {false};
+};
+
+} //namespace Charging
+
+#endif // REPORTSERVER_H
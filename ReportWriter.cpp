@@ -0,0 +1,116 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "ReportWriter.h"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+
+namespace Availability {
+
+namespace {
+
+//The longest entry, a JSONL line with a 10 digit station ID and an 11 character percentage, is 55 bytes
+constexpr std::size_t MAX_ENTRY_SIZE {64};
+
+char* appendLittleEndian ( char* out, uint32_t value ) noexcept {
+    for ( int shift = 0; shift < 32; shift += 8 )
+        *out++ = static_cast<char> ( value >> shift );
+    return out;
+}
+
+} //namespace
+
+ReportWriter::ReportWriter ( std::ostream& os, Format format ) : os {&os}, format {format} {
+    if ( this->format == Format::CSV ) {
+        this->buffer += "station_id,uptime_percent\n";
+    } else if ( this->format == Format::BINARY ) {
+        char header[8];
+        std::ranges::copy ( BINARY_MAGIC, header );
+        appendLittleEndian ( header + BINARY_MAGIC.size(), BINARY_VERSION );
+        this->buffer.append ( header, sizeof header );
+    }
+}
+
+ReportWriter::~ReportWriter() {
+    this->flush();
+}
+
+ReportWriter& ReportWriter::write ( const StationAvailabilityReport& report ) {
+    const auto& entries = report.getEntries();
+    //room for the whole report, unless it's bigger than a flush
+    this->buffer.reserve ( std::min ( this->buffer.size() + entries.size() * MAX_ENTRY_SIZE, FLUSH_SIZE + MAX_ENTRY_SIZE ) );
+    for ( const auto& entry : entries ) {
+        this->append ( entry );
+        if ( this->buffer.size() >= FLUSH_SIZE )
+            this->flush();
+    }
+    return *this;
+}
+
+ReportWriter& ReportWriter::write ( const StationAvailabilityEntry& entry ) {
+    this->append ( entry );
+    if ( this->buffer.size() >= FLUSH_SIZE )
+        this->flush();
+    return *this;
+}
+
+void ReportWriter::flush() {
+    if ( this->buffer.empty() )
+        return;
+    this->os->write ( this->buffer.data(), static_cast<std::streamsize> ( this->buffer.size() ) );
+    this->buffer.clear();
+}
+
+void ReportWriter::append ( const StationAvailabilityEntry& entry ) {
+    char text[MAX_ENTRY_SIZE];
+    char* out = text;
+    auto appendText = [&out] ( std::string_view chars ) { out = std::ranges::copy ( chars, out ).out; };
+    //a uint32_t or int is at most 11 characters
+    auto appendNumber = [&out] ( auto value ) { out = std::to_chars ( out, out + 11, value ).ptr; };
+
+    switch ( this->format ) {
+    case Format::TEXT:
+        //a newline between entries, none after the last. See Spec output sample files.
+        if ( this->entryCount > 0 )
+            *out++ = '\n';
+        appendNumber ( entry.getStationID() );
+        *out++ = ' ';
+        appendNumber ( entry.getUptimePercentage() );
+        break;
+    case Format::CSV:
+        appendNumber ( entry.getStationID() );
+        *out++ = ',';
+        appendNumber ( entry.getUptimePercentage() );
+        *out++ = '\n';
+        break;
+    case Format::JSONL:
+        appendText ( "{\"station_id\":" );
+        appendNumber ( entry.getStationID() );
+        appendText ( ",\"uptime_percent\":" );
+        appendNumber ( entry.getUptimePercentage() );
+        appendText ( "}\n" );
+        break;
+    case Format::BINARY:
+        out = appendLittleEndian ( out, entry.getStationID() );
+        out = appendLittleEndian ( out, std::bit_cast<uint32_t> ( entry.getUptimeFraction() ) );
+        break;
+    }
+    this->buffer.append ( text, out );
+    ++this->entryCount;
+}
+
+std::optional<ReportWriter::Format> ReportWriter::parseFormat ( std::string_view name ) {
+    if ( name == "text" )
+        return Format::TEXT;
+    if ( name == "csv" )
+        return Format::CSV;
+    if ( name == "jsonl" )
+        return Format::JSONL;
+    if ( name == "binary" )
+        return Format::BINARY;
+    return std::nullopt;
+}
+
+} //namespace Availability
@@ -0,0 +1,115 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+#ifndef REPORTWRITER_H
+#define REPORTWRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include "StationAvailabilityReport.h"
+#include "StationAvailabilityEntry.h"
+
+namespace Availability {
+
+/**
+ * @brief Writes a StationAvailabilityReport to any stream: stdout, a file, a string.
+ * Entries are formatted with std::to_chars into one buffer, which goes to the stream in large
+ * writes, of up to FLUSH_SIZE, so a report of hundreds of thousands of Stations is a write or
+ * two rather than a few stream operations per entry.
+ *
+ *      ReportWriter writer {std::cout, ReportWriter::Format::CSV};
+ *      writer.write ( cn.getStationAvailabilityReport() );
+ *      writer.flush(); //or let the destructor do it
+ *
+ * Formats:
+ *
+ *      TEXT    The report of the Spec: "ID percentage" lines, no newline after the last one.
+ *              See Spec Section 2.3.4 to 2.3.9
+ *      CSV     A "station_id,uptime_percent" header line, then one line per entry.
+ *      JSONL   One {"station_id":0,"uptime_percent":100} object per line.
+ *      BINARY  An 8 byte header, BINARY_MAGIC and BINARY_VERSION, then an 8 byte record per
+ *              entry: the station ID as a uint32_t, then the uptime fraction as an IEEE 754
+ *              float, both little-endian whatever the machine.
+ *
+ * The percentage is truncated, as in the Spec report. BINARY keeps the fraction itself.
+ */
+class ReportWriter
+{
+public:
+    enum class Format { TEXT, CSV, JSONL, BINARY };
+
+    /**
+     * @brief The buffer is written out once it holds this much.
+     */
+    static constexpr std::size_t FLUSH_SIZE {8 << 20};
+
+    static constexpr std::string_view BINARY_MAGIC {"E2RP"};
+    static constexpr uint32_t BINARY_VERSION {1};
+    static constexpr std::size_t BINARY_RECORD_SIZE {8};
+
+    /**
+     * @brief Constructor. Nothing is written until the first flush.
+     *
+     * @param os where the report goes. Must outlive the writer.
+     * @param format how it's written
+     */
+    explicit ReportWriter ( std::ostream& os, Format format = Format::TEXT );
+
+    ReportWriter ( const ReportWriter& other ) = delete;
+    ReportWriter& operator= ( const ReportWriter& other ) = delete;
+
+    /**
+     * Destructor. Flushes.
+     */
+    ~ReportWriter();
+
+    /**
+     * @brief Add every entry of a report, in order.
+     *
+     * @param report the report
+     * @return ReportWriter&
+     */
+    ReportWriter& write ( const StationAvailabilityReport& report );
+
+    /**
+     * @brief Add one entry. Entries written one at a time make the same output as a report of them.
+     *
+     * @param entry the entry
+     * @return ReportWriter&
+     */
+    ReportWriter& write ( const StationAvailabilityEntry& entry );
+
+    /**
+     * @brief Hand what's buffered to the stream. Doesn't flush the stream itself.
+     */
+    void flush();
+
+    /**
+     * @brief The Format named text, csv, jsonl or binary.
+     *
+     * @param name the name
+     * @return std::optional<Format> nothing if there's no such format
+     */
+    static std::optional<Format> parseFormat ( std::string_view name );
+
+protected:
+    /**
+     * @brief Format an entry onto the end of buffer.
+     */
+    void append ( const StationAvailabilityEntry& entry );
+
+    std::ostream* os;
+    Format format {Format::TEXT};
+    std::string buffer;
+    uint64_t entryCount {0};
+};
+
+} //namespace Availability
+
+#endif // REPORTWRITER_H
@@ -0,0 +1,77 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "RunStats.h"
+#include "AllocationTracker.h"
+
+#include <sys/resource.h>
+
+namespace Charging {
+
+RunStats::RunStats() : start {std::chrono::steady_clock::now()} {
+}
+
+RunStats::Scope::Scope ( RunStats* stats, std::string_view name ) : stats {stats} {
+    if ( this->stats == nullptr )
+        return;
+    //the slot is taken now, so that phases nested in this one are listed after it
+    this->index = this->stats->phases.size();
+    this->stats->phases.push_back ( {std::string {name}, 0, 0, 0, 0, 0, std::nullopt} );
+    if ( AllocationTracker::isTracking() ) {
+        const AllocationTracker::Counters counters = AllocationTracker::getCounters();
+        this->allocationsAtStart = counters.allocations;
+        this->bytesAtStart = counters.bytes;
+        this->enclosingPeak = AllocationTracker::restartPeak();
+        this->stats->phases[this->index].allocations.emplace();
+    }
+    this->start = std::chrono::steady_clock::now();
+}
+
+RunStats::Scope::~Scope() {
+    if ( this->stats == nullptr )
+        return;
+    Phase& phase = this->stats->phases[this->index];
+    phase.seconds = std::chrono::duration<double> ( std::chrono::steady_clock::now() - this->start ).count();
+    phase.peakRSS = RunStats::peakRSS();
+    if ( phase.allocations and AllocationTracker::isTracking() ) {
+        const AllocationTracker::Counters counters = AllocationTracker::getCounters();
+        phase.allocations->count = counters.allocations - this->allocationsAtStart;
+        phase.allocations->bytes = counters.bytes - this->bytesAtStart;
+        phase.allocations->peakLiveBytes = AllocationTracker::getPeak();
+        AllocationTracker::raisePeak ( this->enclosingPeak );
+    }
+}
+
+void RunStats::Scope::count ( uint64_t lines, uint64_t events, uint64_t bytes ) noexcept {
+    if ( this->stats == nullptr )
+        return;
+    Phase& phase = this->stats->phases[this->index];
+    phase.lines += lines;
+    phase.events += events;
+    phase.bytes += bytes;
+}
+
+long RunStats::peakRSS() noexcept {
+    rusage usage {};
+    getrusage ( RUSAGE_SELF, &usage );
+    return usage.ru_maxrss; //KiB on Linux
+}
+
+void RunStats::writeJson ( std::ostream& os ) const {
+    //Phase names are ours, plain ASCII without quotes or backslashes, so they need no escaping
+    os << "{\"phases\":[";
+    for ( std::size_t i = 0; i < this->phases.size(); ++i ) {
+        const Phase& phase = this->phases[i];
+        os << ( i ? "," : "" ) << "{\"name\":\"" << phase.name << "\",\"seconds\":" << phase.seconds
+           << ",\"lines\":" << phase.lines << ",\"events\":" << phase.events << ",\"bytes\":" << phase.bytes
+           << ",\"peak_rss_kib\":" << phase.peakRSS;
+        if ( phase.allocations )
+            os << ",\"allocations\":" << phase.allocations->count << ",\"allocated_bytes\":" << phase.allocations->bytes
+               << ",\"peak_live_bytes\":" << phase.allocations->peakLiveBytes;
+        os << "}";
+    }
+    const double total = std::chrono::duration<double> ( std::chrono::steady_clock::now() - this->start ).count();
+    os << "],\"total_seconds\":" << total << ",\"peak_rss_kib\":" << peakRSS() << "}\n";
+}
+
+} //namespace Charging
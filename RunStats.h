@@ -0,0 +1,137 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+#ifndef RUNSTATS_H
+#define RUNSTATS_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Charging {
+
+/**
+ * @brief Wall time, work done and peak memory of each phase of a run, for --stats.
+ *
+ * A phase is timed by a Scope, which is a no-op when there's no RunStats to record into, so code
+ * can be instrumented unconditionally and pay nothing unless asked:
+ *
+ *      void parse ( std::string_view bytes, RunStats* stats ) {
+ *          RunStats::Scope phase {stats, "stations"};
+ *          ...
+ *          if ( phase )
+ *              phase.count ( lines, 0, bytes.size() );
+ *      }
+ *
+ * Phases are listed in the order they started. Counting lines or events is left to the caller,
+ * and should only be done if the Scope is recording. Not safe to record into from several
+ * threads at once; phases are recorded on the thread which runs them.
+ *
+ * While there's an AllocationTracker, each phase also gets the heap allocations made during it,
+ * by any thread. A phase's peak includes the phases nested in it.
+ */
+class RunStats
+{
+public:
+    struct Phase {
+        std::string name;
+        double seconds {0};     ///< wall time
+        uint64_t lines {0};     ///< lines of the data file read
+        uint64_t events {0};    ///< availability events read or processed
+        uint64_t bytes {0};     ///< bytes read or written
+        long peakRSS {0};       ///< peak resident set size of the process at the end of the phase, in KiB
+
+        struct Allocations {
+            uint64_t count {0};
+            uint64_t bytes {0};
+            int64_t peakLiveBytes {0};  ///< the most live at once. See AllocationTracker.
+        };
+        std::optional<Allocations> allocations; ///< only if there was an AllocationTracker
+    };
+
+    /**
+     * @brief Times one phase, from construction to destruction, and records it.
+     */
+    class Scope
+    {
+    public:
+        /**
+         * @brief Constructor. Starts the phase.
+         *
+         * @param stats where to record it. nullptr records nothing.
+         * @param name name of the phase
+         */
+        Scope ( RunStats* stats, std::string_view name );
+
+        /**
+         * Destructor. Ends the phase and records it.
+         */
+        ~Scope();
+
+        Scope ( const Scope& other ) = delete;
+        Scope& operator= ( const Scope& other ) = delete;
+
+        /**
+         * @brief Add to the work done in this phase.
+         */
+        void count ( uint64_t lines, uint64_t events, uint64_t bytes ) noexcept;
+
+        /**
+         * @brief Whether the phase is being recorded, i.e. whether counting is worth it.
+         */
+        explicit operator bool() const noexcept { return this->stats != nullptr; }
+
+    private:
+        RunStats* stats;
+        std::size_t index {0};
+        std::chrono::steady_clock::time_point start;
+        uint64_t allocationsAtStart {0};
+        uint64_t bytesAtStart {0};
+        int64_t enclosingPeak {0};  ///< of the phase this one is nested in, put back at the end
+    };
+
+    /**
+     * Default constructor. The run starts now.
+     */
+    RunStats();
+
+    /**
+     * @brief The phases recorded so far, in the order they started.
+     *
+     * @return const std::vector<Phase>&
+     */
+    const std::vector<Phase>& getPhases() const noexcept { return this->phases; }
+
+    /**
+     * @brief Write everything recorded as one JSON object, on one line:
+     *
+     *      {"phases":[{"name":"open","seconds":0.000012,"lines":0,"events":0,"bytes":60825453,"peak_rss_kib":3456},...],
+     *       "total_seconds":0.61,"peak_rss_kib":115712}
+     *
+     * Phases with allocations counted also have "allocations", "allocated_bytes" and "peak_live_bytes".
+     *
+     * @param os where to write it
+     */
+    void writeJson ( std::ostream& os ) const;
+
+    /**
+     * @brief Peak resident set size of this process so far, in KiB.
+     *
+     * @return long
+     */
+    static long peakRSS() noexcept;
+
+protected:
+    std::chrono::steady_clock::time_point start;
+    std::vector<Phase> phases;
+};
+
+} //namespace Charging
+
+#endif // RUNSTATS_H
@@ -0,0 +1,144 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "SortedRunMerger.h"
+
+#include <algorithm>
+#include <bit>
+#include <functional>
+
+namespace Availability {
+
+SortedRunMerger::SortedRunMerger ( IntervalSort::Algorithm sortAlgorithm ) : sortAlgorithm {sortAlgorithm} {
+}
+
+SortedRunMerger::~SortedRunMerger() = default;
+
+std::size_t SortedRunMerger::nextAvailable ( const AvailabilityEventStore& events, std::size_t index ) noexcept {
+    //a word at a time, so a long stretch of downtime is skipped 64 events per step
+    const auto words = events.availableWords();
+    std::size_t word = index >> 6;
+    if ( word >= words.size() )
+        return events.size();
+    uint64_t bits = words[word] & ( ~uint64_t {0} << ( index & 63 ) );
+    while ( bits == 0 ) {
+        if ( ++word == words.size() )
+            return events.size();
+        bits = words[word];
+    }
+    return std::min ( ( word << 6 ) + std::countr_zero ( bits ), events.size() );
+}
+
+bool SortedRunMerger::addRun ( const AvailabilityEventStore& events ) {
+    if ( events.empty() )
+        return true;
+    this->earliestStart = std::min ( this->earliestStart, std::ranges::min ( events.startTimes() ) );
+    this->latestEnd = std::max ( this->latestEnd, std::ranges::max ( events.endTimes() ) );
+
+    nanoseconds_t previousStart {0};
+    bool sorted {true};
+    bool anyAvailable {false};
+    for ( std::size_t i = nextAvailable ( events, 0 ); i < events.size(); i = nextAvailable ( events, i + 1 ) ) {
+        if ( events.startTime ( i ) < previousStart ) {
+            sorted = false;
+            break;
+        }
+        previousStart = events.startTime ( i );
+        anyAvailable = true;
+    }
+
+    if ( sorted ) {
+        if ( anyAvailable )
+            this->runs.push_back ( &events );
+        return true;
+    }
+
+    //Out of order. Sort the available events of this Charger only, and merge the copy.
+    std::vector<IntervalSort::Interval> intervals;
+    for ( std::size_t i = nextAvailable ( events, 0 ); i < events.size(); i = nextAvailable ( events, i + 1 ) ) {
+        intervals.push_back ( {events.startTime ( i ), events.endTime ( i )} );
+    }
+    IntervalSort::sort ( intervals, this->sortAlgorithm );
+    auto& copy = this->sortedCopies.emplace_back();
+    copy.reserve ( intervals.size() );
+    for ( const auto& [startTime, endTime] : intervals ) {
+        copy.push_back ( startTime, endTime, true );
+    }
+    this->runs.push_back ( &copy );
+    return false;
+}
+
+template<typename OnInterval>
+void SortedRunMerger::sweep ( OnInterval&& onInterval ) const {
+    //Heap entry: start time of a run's next event, and which run
+    using Head = std::pair<nanoseconds_t, std::size_t>;
+    std::vector<Head> heap;
+    std::vector<std::size_t> positions ( this->runs.size() );
+    heap.reserve ( this->runs.size() );
+    for ( std::size_t r = 0; r < this->runs.size(); ++r ) {
+        positions[r] = nextAvailable ( *this->runs[r], 0 );
+        heap.emplace_back ( this->runs[r]->startTime ( positions[r] ), r );
+    }
+    std::ranges::make_heap ( heap, std::greater() );
+
+    nanoseconds_t currentStart {0};
+    nanoseconds_t currentEnd {0};
+    bool open {false};
+
+    while ( not heap.empty() ) {
+        std::ranges::pop_heap ( heap, std::greater() );
+        const auto [startTime, r] = heap.back();
+        const AvailabilityEventStore& run = *this->runs[r];
+        const nanoseconds_t endTime = run.endTime ( positions[r] );
+
+        //coalesce on the fly: extend the current interval, or close it and open a new one
+        if ( not open ) {
+            currentStart = startTime;
+            currentEnd = endTime;
+            open = true;
+        } else if ( startTime > currentEnd ) {
+            onInterval ( currentStart, currentEnd );
+            currentStart = startTime;
+            currentEnd = endTime;
+        } else if ( endTime > currentEnd ) {
+            currentEnd = endTime;
+        }
+
+        positions[r] = nextAvailable ( run, positions[r] + 1 );
+        if ( positions[r] < run.size() ) {
+            heap.back() = {run.startTime ( positions[r] ), r};
+            std::ranges::push_heap ( heap, std::greater() );
+        } else {
+            heap.pop_back();
+        }
+    }
+    if ( open )
+        onInterval ( currentStart, currentEnd );
+}
+
+nanoseconds_t SortedRunMerger::coveredLength() const {
+    nanoseconds_t covered {0};
+    this->sweep ( [&covered] ( nanoseconds_t startTime, nanoseconds_t endTime ) {
+        covered += endTime - startTime;
+    } );
+    return covered;
+}
+
+std::vector<IntervalSort::Interval> SortedRunMerger::mergedIntervals() const {
+    std::vector<IntervalSort::Interval> merged;
+    this->sweep ( [&merged] ( nanoseconds_t startTime, nanoseconds_t endTime ) {
+        //zero-length intervals cover nothing, and would only make the index bigger
+        if ( startTime != endTime )
+            merged.push_back ( {startTime, endTime} );
+    } );
+    return merged;
+}
+
+void SortedRunMerger::clear() noexcept {
+    this->runs.clear();
+    this->sortedCopies.clear();
+    this->earliestStart = UINT64_MAX;
+    this->latestEnd = 0;
+}
+
+} //namespace Availability
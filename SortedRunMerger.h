@@ -0,0 +1,140 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+#ifndef SORTEDRUNMERGER_H
+#define SORTEDRUNMERGER_H
+
+#include "AvailabilityEvent.h"
+#include "AvailabilityEventStore.h"
+#include "IntervalSort.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <utility>
+#include <vector>
+
+namespace Availability {
+
+/**
+ * @brief Length of the union of the available events of several Chargers, by merging them.
+ * See Spec Section 2.3.
+ *
+ * A Charger's reports nearly always arrive in time order, so each Charger's available events
+ * are already a sorted run. Rather than copying every run into one vector and sorting it, the
+ * runs are merged in place with a k-way sweep: a min-heap holds the next event of every run,
+ * and each event popped either extends the current covered interval or closes it and starts a
+ * new one. That's O(n log k) for n events from k Chargers, and no copy of the events.
+ *
+ * A Charger whose available events are not in start time order is copied and sorted on its
+ * own, with the IntervalSort::Algorithm given to the constructor, then merged like the others.
+ *
+ *      SortedRunMerger merger;
+ *      for ( const auto& charger : station.chargers )
+ *          merger.addRun ( charger->availabilityEvents );
+ *      nanoseconds_t numerator = merger.coveredLength();
+ *
+ * Only the available events count; downtime events are skipped while merging.
+ * The stores must outlive the merger, or at least its last call to coveredLength().
+ */
+class SortedRunMerger
+{
+public:
+    /**
+     * Constructor.
+     *
+     * @param sortAlgorithm how the events of a Charger which isn't in order are sorted
+     */
+    explicit SortedRunMerger ( IntervalSort::Algorithm sortAlgorithm = IntervalSort::Algorithm::COMPARISON );
+
+    SortedRunMerger ( const SortedRunMerger& other ) = delete;
+    SortedRunMerger& operator= ( const SortedRunMerger& other ) = delete;
+
+    /**
+     * Destructor. C++ default.
+     */
+    ~SortedRunMerger();
+
+    /**
+     * @brief Add the available events of one Charger.
+     * All of its events, available or not, count towards earliestStartTime() and latestEndTime().
+     *
+     * @param events the Charger's events, in any order
+     * @return true if they were already in start time order and are merged in place
+     */
+    bool addRun ( const AvailabilityEventStore& events );
+
+    /**
+     * @brief Total time covered by at least one available event of any run added.
+     *
+     * @return nanoseconds_t
+     */
+    nanoseconds_t coveredLength() const;
+
+    /**
+     * @brief The union of the available events of all runs added, as disjoint intervals in
+     * time order. Intervals which touch are joined.
+     *
+     * @return std::vector<IntervalSort::Interval>
+     */
+    std::vector<IntervalSort::Interval> mergedIntervals() const;
+
+    /**
+     * @brief Earliest start time of any event of any run added, available or not.
+     * UINT64_MAX if there were no events. See Spec Section 2.3.
+     *
+     * @return nanoseconds_t
+     */
+    nanoseconds_t earliestStartTime() const noexcept { return this->earliestStart; }
+
+    /**
+     * @brief Latest end time of any event of any run added, available or not. 0 if there were no events.
+     *
+     * @return nanoseconds_t
+     */
+    nanoseconds_t latestEndTime() const noexcept { return this->latestEnd; }
+
+    /**
+     * @brief Forget all runs.
+     */
+    void clear() noexcept;
+
+protected:
+    /**
+     * @brief The k-way sweep. Calls onInterval(startTime, endTime) for each disjoint interval of
+     * the union, in time order.
+     *
+     * @param onInterval callable taking two nanoseconds_t
+     */
+    template<typename OnInterval>
+    void sweep ( OnInterval&& onInterval ) const;
+
+    /**
+     * @brief Index of the first available event at or after index, or events.size() if none.
+     */
+    static std::size_t nextAvailable ( const AvailabilityEventStore& events, std::size_t index ) noexcept;
+
+    /**
+     * @brief The runs: stores whose available events are in start time order.
+     */
+    std::vector<const AvailabilityEventStore*> runs;
+
+    /**
+     * @brief Sorted copies of the available events of Chargers that weren't in order.
+     * A deque, so the addresses in runs stay valid as copies are added.
+     */
+    std::deque<AvailabilityEventStore> sortedCopies;
+
+    /**
+     * @brief How sortedCopies are sorted.
+     */
+    IntervalSort::Algorithm sortAlgorithm;
+
+    nanoseconds_t earliestStart {UINT64_MAX};
+    nanoseconds_t latestEnd {0};
+};
+
+} //namespace Availability
+
+#endif // SORTEDRUNMERGER_H
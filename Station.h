@@ -12,12 +12,19 @@ using std::ostream;
 
 #include <algorithm>
 #include <map>
+#include <unordered_map>
 #include <memory>
+#include <span>
 
 #include "Charger.h"
 
 namespace Availability {
     class StationAvailabilityReportFactory; //forward declaration
+    class UptimeIndex; //forward declaration
+    class IncrementalUptime; //forward declaration
+}
+namespace Charging {
+    class NetworkSnapshot; //forward declaration
 }
 
 namespace ChargingNodes {
@@ -121,8 +128,22 @@ public:
 
     stationID_t getStationID() const;
     void insertCharger( shared_ptr<ChargingNodes::Charger> charger );
+
+    /**
+     * @brief Returns the Charger's of this Station, in the order they were inserted.
+     * A read-only view, valid until the next insertCharger(): neither the vector nor the
+     * shared_ptr's are copied.
+     *
+     * @return std::span<const shared_ptr<Charger>>
+     */
+    std::span<const shared_ptr<ChargingNodes::Charger>> getChargers() const {
+        return this->chargers;
+    }
     friend std::ostream& operator <<  (std::ostream& os, const Station& s);
     friend class Availability::StationAvailabilityReportFactory;
+    friend class Charging::NetworkSnapshot;
+    friend class Availability::UptimeIndex;
+    friend class Availability::IncrementalUptime;
 
 
 protected:
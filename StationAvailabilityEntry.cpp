@@ -2,7 +2,6 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include "StationAvailabilityEntry.h"
-#include <iostream>
 #include <cmath>
 
 namespace Availability {
@@ -29,6 +28,10 @@ bool StationAvailabilityEntry::operator<(const StationAvailabilityEntry& other)
     return result;
 }
 
+bool StationAvailabilityEntry::operator==(const StationAvailabilityEntry& other) const noexcept {
+    return this->stationID == other.stationID and this->uptimeFraction == other.uptimeFraction;
+}
+
 constexpr std::partial_ordering StationAvailabilityEntry::operator<=>(const StationAvailabilityEntry& other) const noexcept {
     if (auto c = this->stationID <=> other.stationID; c != 0)
         return c;
@@ -36,10 +39,7 @@ constexpr std::partial_ordering StationAvailabilityEntry::operator<=>(const Stat
 }
 
 std::ostream& operator<<(std::ostream& os, const StationAvailabilityEntry& sae) {
-    std::cout << sae.stationID << " ";
-    //truncate and convert to int. C++ automatically truncates during the conversion.
-    const int intPercentage = static_cast<int> (sae.uptimeFraction*100);
-    std::cout << intPercentage;
+    os << sae.stationID << " " << sae.getUptimePercentage();
     return os;
 }
 } //namespace Availability
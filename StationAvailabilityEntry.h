@@ -69,6 +69,14 @@ public:
      */
     bool  operator<(const StationAvailabilityEntry& other) const noexcept;
 
+    /**
+     * @brief Equality operator.
+     *
+     * @param other object to compare
+     * @return true if stationID and uptimeFraction are both equal
+     */
+    bool operator==(const StationAvailabilityEntry& other) const noexcept;
+
     /**
      * @brief Spaceship comparison operator.
      *
@@ -79,6 +87,20 @@ public:
      */
     constexpr std::partial_ordering operator<=>(const StationAvailabilityEntry& other) const noexcept;
 
+    ChargingNodes::stationID_t getStationID() const noexcept { return this->stationID; }
+    float getUptimeFraction() const noexcept { return this->uptimeFraction; }
+
+    /**
+     * @brief The uptime as the report shows it: a percentage, truncated to an integer.
+     * So, 12.5% is 12, and so is 12.79%. See Spec Section 2.3.8
+     *
+     * @return int
+     */
+    int getUptimePercentage() const noexcept {
+        //C++ truncates during the conversion
+        return static_cast<int> ( this->uptimeFraction * 100 );
+    }
+
     friend std::ostream& operator<<(std::ostream& os, const StationAvailabilityEntry& sae);
     friend class StationAvailabilityReportFactory;
 
@@ -3,6 +3,7 @@
 
 #include "Charging.h"
 #include "StationAvailabilityReport.h"
+#include "ReportWriter.h"
 #include <iostream>
 #include <algorithm>
 
@@ -25,6 +26,10 @@ StationAvailabilityReport& StationAvailabilityReport::operator+=(const StationAv
     return *this;
 }
 
+bool StationAvailabilityReport::operator==(const StationAvailabilityReport& other) const {
+    return this->stationAvailabilityEntries == other.stationAvailabilityEntries;
+}
+
 void StationAvailabilityReport::sort() {
 
     namespace ranges = std::ranges; //namespace shortcut
@@ -33,18 +38,8 @@ void StationAvailabilityReport::sort() {
 }
 
 std::ostream& operator<< (std::ostream& os, const StationAvailabilityReport& sar) {
-    Debug( "StationAvailabilityReport\n" );
-
-    //Unfortunately, we have to NOT emit a newline at the end of the uptime entries.
-    //This complicates the logic to support that. See the sample output files in Specification.
-    int count = sar.stationAvailabilityEntries.size();
-    int newlinesRemaining = count - 1;
-    for (auto i : sar.stationAvailabilityEntries) {
-        std::cout << i;
-        if (newlinesRemaining-- > 0) {
-            std::cout << "\n";
-        }
-    }
+    //Formatted into one buffer and written in one go. See ReportWriter::Format::TEXT.
+    ReportWriter(os).write(sar);
     return os;
 }
 
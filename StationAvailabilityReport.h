@@ -67,12 +67,27 @@ public:
      */
     StationAvailabilityReport& operator+=(const StationAvailabilityEntry& sae);
 
+    /**
+     * @brief Equality operator.
+     *
+     * @param other the report being compared with
+     * @return true if both reports have the same entries in the same order
+     */
+    bool operator==(const StationAvailabilityReport& other) const;
+
     /**
      * @brief Sort the report entries by stationID.
      *
      */
     void sort();
 
+    /**
+     * @brief The entries, in the order they were inserted (station ID order after sort()).
+     *
+     * @return const vector<StationAvailabilityEntry>&
+     */
+    const vector<StationAvailabilityEntry>& getEntries() const noexcept { return this->stationAvailabilityEntries; }
+
     friend std::ostream& operator<< (std::ostream& os, const StationAvailabilityReport& sar);
 
 
@@ -88,7 +103,7 @@ protected:
 };
 
 /**
- * @brief Write to output stream.
+ * @brief Write to output stream, as the Spec report. See ReportWriter for other formats.
  * Only emits a newline after entries <em>other than</em> the first one.
  * This means there is no newline after the last entry.
  * There is no newline if there are no entries.
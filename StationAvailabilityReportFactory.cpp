@@ -5,9 +5,16 @@
 #include "StationAvailabilityReportFactory.h"
 #include "StationAvailabilityEntry.h"
 #include "AvailabilityEvent.h"
+#include "AvailabilityEventStore.h"
 #include "Charger.h"
+#include "ParallelFor.h"
+#include "SortedRunMerger.h"
 #include <iostream>
 #include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <string>
 #include <ranges>
 #include <assert.h>
 
@@ -18,7 +25,10 @@ namespace Availability {
 
 StationAvailabilityReportFactory::StationAvailabilityReportFactory() = default;
 
-StationAvailabilityReportFactory::StationAvailabilityReportFactory(map<stationID_t, shared_ptr<ChargingNodes::Station>> stations) : stations{stations} {
+StationAvailabilityReportFactory::StationAvailabilityReportFactory(const map<stationID_t, shared_ptr<ChargingNodes::Station>>& stations, unsigned threadCount,
+                                                                   UptimeEngine engine, IntervalSort::Algorithm sortAlgorithm,
+                                                                   Charging::RunStats* stats) :
+    stations{&stations}, threadCount{Charging::resolveThreadCount(threadCount)}, engine{engine}, sortAlgorithm{sortAlgorithm}, stats{stats} {
 }
 
 StationAvailabilityReportFactory::StationAvailabilityReportFactory(const StationAvailabilityReportFactory& other) = default;
@@ -27,20 +37,33 @@ StationAvailabilityReportFactory::~StationAvailabilityReportFactory() = default;
 
 StationAvailabilityReportFactory& StationAvailabilityReportFactory::operator=(const StationAvailabilityReportFactory& other) = default;
 
+float StationAvailabilityReportFactory::uptimeFraction( nanoseconds_t numerator, nanoseconds_t denominator ) {
+    return static_cast<float>(numerator)/denominator;
+}
+
+float StationAvailabilityReportFactory::chargerUptimeFraction( const ChargingNodes::Charger& charger ) {
+    SortedRunMerger merger;
+    merger.addRun( charger.getAvailabilityEvents() );
+    return uptimeFraction( merger.coveredLength(), merger.latestEndTime() - merger.earliestStartTime() );
+}
+
 /**
  * \internal
  * Create and return the station availability report.
  *
- * Strategy: Iterate over the cached Stations.
+ * Strategy: Iterate over the cached Stations, on threadCount threads if asked to.
+ * See getEntry() for a single Station.
  * Every Station has multiple Chargers, which have multiple AvailabilityEvent's.
- * So, for every Station,
- * create a consolidated vector of AvailabilityEvent's. This may have duplicates.
  * To calculate the uptimeFraction, we need to know the numerator and denominator.
  * The denominator is simply the latestEndTime-earliestStartTime.
- * The numerator is more complicated:
- * Remove the overlapping AvailabilityEvent's in the consolidated vector of AvailabilityEvent's.
- * Then calculate uptime from the vector of non-overlapping AvailabilityEvent's.
- * Add entries to a StationAvailabilityReport and return the report.
+ * The numerator is the time covered by the Station's available AvailabilityEvent's.
+ * With KWAY_MERGE, the default, each Charger's events are already sorted, so they're merged as
+ * sorted runs with a SortedRunMerger, which adds up the covered time as it goes. Nothing is
+ * copied or sorted.
+ * With CONSOLIDATE_SORT, the available events of all the Chargers are copied into one vector,
+ * which may have duplicates. removeOverlaps() sorts it and removes the overlaps, and
+ * calculateUptime() adds up what's left.
+ * Add entries to a StationAvailabilityReport, sort it and return the report.
  *
  * See Spec Section 2.3
  *
@@ -50,187 +73,269 @@ StationAvailabilityReportFactory& StationAvailabilityReportFactory::operator=(co
  */
 StationAvailabilityReport StationAvailabilityReportFactory::getReport() {
 
-    Debug( "StationAvailabilityReport StationAvailabilityReportFactory::getReport() {\n" );
+    Trace( REPORT, INFO, "report: stations, threads", this->stations->size(), this->threadCount );
     StationAvailabilityReport report;
 
-    //Iterate over Station's. Note the earliest start time and latest end time, so we can know
-    //the max time span we are calculating uptime for. Create a consolidated vector of all
-    //AvailabilityEvent's for this Station (not broken up by Charger). This vector will not contain
-    //downtime (non-available) events.
-    for (const auto& [k,station] : this->stations) { //key is stationID, value is Station
-
-        vector<AvailabilityEvent> vaeConsolidated; //Consolidated vector of AvailabilityEvent's
+    //Each Station writes its own slot, so no lock is needed, and the slots are in station ID
+    //order whichever thread finished first.
+    vector<StationAvailabilityEntry> entries( this->stations->size() );
+    {
+        Charging::RunStats::Scope phase {this->stats, this->engine == UptimeEngine::KWAY_MERGE ? "report merge" : "report consolidate"};
+        this->forEachStation( [&entries, this] (std::size_t slot, const ChargingNodes::Station& station) {
+            entries[slot] = this->getEntry( station );
+            Trace( REPORT, DEBUG, "station uptime: station, percent", entries[slot].getStationID(), entries[slot].getUptimePercentage() );
+        } );
+        if (phase) {
+            uint64_t events {0};
+            for (const auto& [k,station] : *this->stations) {
+                for (const auto& charger : station->getChargers())
+                    events += charger->getAvailabilityEvents().size();
+            }
+            phase.count( 0, events, 0 );
+        }
+    }
 
-        nanoseconds_t earliestStartTime {UINT64_MAX};  // start with the highest value, and work downards.
-        nanoseconds_t latestEndTime {0};               //  start with the lowest value and work upwards.
+    Charging::RunStats::Scope phase {this->stats, "report sort"};
+    for (const auto& entry : entries) {
+        report += entry;
+    }
+    report.sort(); //See Spec Section 2.3.9
+    return report;
 
-        Debug( "Charger loop:\n" );
+}
 
-        //It's possible the algorithm could be made even more efficient, but let's keep it simple for future maintenance's sake
-        for (const auto& charger : station->chargers) {
+UptimeSeriesReport StationAvailabilityReportFactory::getSeriesReport( nanoseconds_t bucketWidth ) {
+    UptimeSeriesReport report {bucketWidth};
+    vector<StationUptimeSeries> series( this->stations->size() );
+    std::atomic<std::size_t> totalBuckets {0};
+    this->forEachStation( [&series, &totalBuckets, bucketWidth, this] (std::size_t slot, const ChargingNodes::Station& station) {
+        //the same merged intervals getEntry() sums up, swept into buckets instead
+        SortedRunMerger merger {this->sortAlgorithm};
+        for (const auto& charger : station.getChargers()) {
+            merger.addRun( charger->getAvailabilityEvents() );
+        }
+        //counted before the buckets are allocated, so a too narrow width fails rather than exhausting memory
+        const std::size_t buckets = StationUptimeSeries::bucketCount( merger.earliestStartTime(), merger.latestEndTime(), bucketWidth );
+        if (totalBuckets.fetch_add( buckets ) + buckets > UptimeSeriesReport::MAX_BUCKETS) {
+            throw std::length_error( "Bucket width " + std::to_string( bucketWidth ) + " makes more than "
+                                     + std::to_string( UptimeSeriesReport::MAX_BUCKETS ) + " buckets" );
+        }
+        series[slot] = StationUptimeSeries::sweep( station.getStationID(), merger.mergedIntervals(),
+                                                   merger.earliestStartTime(), merger.latestEndTime(), bucketWidth );
+    } );
+    for (auto& stationSeries : series) { //already in station ID order
+        report += std::move( stationSeries );
+    }
+    return report;
+}
 
-            Debug( charger << "\n" );
-            //Debug( charger->availabilityEvents );
+void StationAvailabilityReportFactory::forEachStation( const std::function<void(std::size_t, const ChargingNodes::Station&)>& work ) const {
+    if (this->threadCount <= 1 or this->stations->size() <= 1) {
+        std::size_t slot {0};
+        for (const auto& [k,station] : *this->stations) { //key is stationID, value is Station
+            work( slot++, *station );
+        }
+        return;
+    }
 
-            Debug( "availabilityEvent loop:\n" );
-            for (const auto& availabilityEvent : charger->availabilityEvents ) {
-                Debug( *availabilityEvent );
+    vector<const ChargingNodes::Station*> ordered;
+    ordered.reserve( this->stations->size() );
+    for (const auto& [k,station] : *this->stations) {
+        ordered.push_back( station.get() );
+    }
 
-                if (earliestStartTime > availabilityEvent->startTime )
-                    earliestStartTime = availabilityEvent->startTime ;
+    //Every Station is independent of the others, so each one is a work item.
+    //Station sizes are heavily skewed (a few depots have thousands of Chargers), so the biggest
+    //Stations are handed out first; the small ones then fill in around them. Otherwise a big
+    //Station drawn last would leave every other thread idle while it finishes.
+    vector<std::size_t> eventCounts;
+    eventCounts.reserve( ordered.size() );
+    for (const auto* station : ordered) {
+        std::size_t eventCount {0};
+        for (const auto& charger : station->getChargers())
+            eventCount += charger->getAvailabilityEvents().size();
+        eventCounts.push_back( eventCount );
+    }
+    vector<std::size_t> schedule( ordered.size() );
+    std::iota( schedule.begin(), schedule.end(), 0 );
+    std::ranges::stable_sort( schedule, std::greater(), [&eventCounts] (std::size_t i) { return eventCounts[i]; } );
+
+    Charging::parallelFor( schedule.size(), this->threadCount, [&] (std::size_t i) {
+        const std::size_t slot = schedule[i];
+        work( slot, *ordered[slot] );
+    } );
+}
 
-                if (latestEndTime < availabilityEvent->endTime)
-                    latestEndTime = availabilityEvent->endTime;
+StationAvailabilityEntry StationAvailabilityReportFactory::getEntry( const ChargingNodes::Station& station ) const {
 
-                if (! false==availabilityEvent->available) //we discard the downtime events
-                    vaeConsolidated.push_back( *availabilityEvent );
-            }
+    if (this->engine == UptimeEngine::KWAY_MERGE) {
+        //Same numerator and denominator as below, without copying or sorting the events
+        SortedRunMerger merger {this->sortAlgorithm};
+        for (const auto& charger : station.getChargers()) {
+            merger.addRun( charger->getAvailabilityEvents() );
         }
+        Trace( MERGE, DEBUG, "station merged: station, Chargers", station.getStationID(), station.getChargers().size() );
+        return StationAvailabilityEntry(station.getStationID(),
+                                        uptimeFraction( merger.coveredLength(), merger.latestEndTime() - merger.earliestStartTime() ));
+    }
 
-        Debug( "End Charger loop\n" );
-        Debug( "vaeConsolidated: \n" << vaeConsolidated << "end vaeConsolidated\n");
-
-        const nanoseconds_t denominator = latestEndTime - earliestStartTime;
-
-        auto calculateUptime = [] ( const vector<AvailabilityEvent>& vaeNoOverlaps, const nanoseconds_t denominator ) {
-            Debug( "calculateUptime()\n" );
-            //Calculate the fraction of time that any charger at a station was available,
-            //(by adding up the time that any charger was available
-            //out of the entire time period that any charger at that station was reporting in.
-            //(known by the denominator we're passed)
-            //See Spec Section 2.3.
-            //We return the fraction as a float; callers can calculate percent by multipying by 100 as desired.
-            //This function assumes we're passed a vector with no overlapping AvailabilityEvent's. If there are
-            //overlaps, the fraction will be wrong and may even be more than 1.
-            Debug( "vaeNoOverlaps in calculateUptime() \n" << vaeNoOverlaps );
-            nanoseconds_t availableDurationCumulative {0};
-            for (const auto& availabilityEvent : vaeNoOverlaps) {
-                availableDurationCumulative += (availabilityEvent.endTime - availabilityEvent.startTime);
-            }
-            const nanoseconds_t numerator = availableDurationCumulative; //superfluous, but it in code bc comments get out of synch. Compiler will remove
-            const auto uptimeFraction = static_cast<float>(numerator)/denominator;
-            return uptimeFraction;
-        };
-
-
-        auto removeOverlaps = [&vaeConsolidated] () {
-            Debug( "removeOverlaps()\n" );
-            /*
-
-            Remove overlapping AvailabilityEvent's in vaeConsolidated and write
-            non-overlapping durations as AvailabilityEvent's to vaeNoOverlaps, which is returned.
-
-            Out strategy is to sort vaeConsolidated, iterate over it, compare the current
-            AvailabilityEvent to the previous one. According to the logic below, either
-            add the current AvailabilityEvent to vaeNoOverlaps, add a new AvailabilityEvent
-            which has its startTime reset to the previous AvailabilityEvent's endTime, or do
-            nothing.
-
-            If comparing two AvailabilityEvent's A and B, there are 5 possible cases:
-
-            Case 0:
-            A. ---------
-            B.            --------
-
-            Case 1:
-            A. --------
-            B.     -------
-
-            Case 2:
-            A.      --------
-            B. --------
-
-            Case 3:
-            A. --------------'
-            B.     ------
-
-            Case 4:
-            A.       ------
-            B.  ---------------
-
-            Bc we sort the items,  there should only be cases 0, 1, and 3. But if we handle
-            case 1 as below, that can result in there being a case 2 or 4 for following iterations.:
-            0. Add B to vaeNoOverlaps. (A is already in)
-            1, 2, 4. Set B.start = A.end and add B.
-            3. Drop B.
-
-            */
-
-            //sort vaeConsolidated, move the first item to a new vector of AvailabilityEvent's: vaeNoOverlaps.
-            //Tho, if empty, return
-            //It's expensive to remove the first element, so we don't remove it.
-            //We just iterate fr the 2nd element in the for loop in next paragraph.
-            vector<AvailabilityEvent> vaeNoOverlaps;
-            if (vaeConsolidated.empty())
-                return vaeNoOverlaps;
-            std::ranges::sort(vaeConsolidated, std::less());
-            vaeNoOverlaps.push_back( vaeConsolidated.at(0) );
-            Debug ( "vaeConsolidated, sorted " << vaeConsolidated );
-            Debug ( "vaeNoOverlaps " << vaeNoOverlaps );
-            if (vaeConsolidated.size() == 1) //bail if there was only one element
-                return vaeNoOverlaps;
-
-            //iterate fr the 2nd element forward, bc we already added 1st to vaeNoOverlaps
-            //in each iteration, a is the previous AvailabilityEvent. I.e., the last element in vaeNoOverlaps.
-            //b is the current AvailabilityEvent
-            for (const auto& b : std::ranges::drop_view{vaeConsolidated, 1}) {
-                const auto& a = vaeNoOverlaps.at(vaeNoOverlaps.size()-1);
-                Debug( "a: " << a );
-                Debug( "b: " << b );
-
-                if (a.endTime <= b.startTime) {
-                    Debug( "case 0\n" );
-                    // Add b
-                    vaeNoOverlaps.push_back( b );
-                } else if (a.endTime > b.startTime && b.startTime > a.startTime && a.endTime < b.endTime) {
-                    Debug( "case 1\n" );
-                    // Set b.start = a.end. Add b.
-                    // The = case doesn't need to be handled here bc it was handled in 0.
-                    AvailabilityEvent aeNew{ b };
-                    aeNew.startTime = a.endTime; Debug( "aeNew: " << aeNew );
-                    if (not (aeNew.startTime == aeNew.endTime))
-                        vaeNoOverlaps.push_back( aeNew );
-                } else if (a.startTime > b.startTime and a.endTime >= b.endTime) {
-                    Debug( "case 2\n" );
-                    // Set b.start = a.end. Add b.
-                    AvailabilityEvent aeNew{ b };
-                    aeNew.startTime = a.endTime; Debug( "aeNew: " << aeNew );
-                    if (not (aeNew.startTime == aeNew.endTime))
-                        vaeNoOverlaps.push_back( aeNew );
-                } else if (b.startTime >= a.startTime and a.endTime >= b.endTime) {
-                    Debug( "case 3\n" );
-                    // Dont add b
-                } else if (a.startTime > b.startTime and a.endTime <= b.endTime) {
-                    Debug( "case 4\n" );
-                    // Set b.start = a.end. Add b.
-                    AvailabilityEvent aeNew{ b };
-                    aeNew.startTime = a.endTime; Debug( "aeNew: " << aeNew );
-                    if (not (aeNew.startTime == aeNew.endTime))
-                        vaeNoOverlaps.push_back( aeNew );
-                } else {
-                    Debug( "Shouldn't get here\n" );
-                    assert(false);
-                }
-            }
+    vector<AvailabilityEvent> vaeConsolidated; //Consolidated vector of AvailabilityEvent's
 
-            Debug( "vaeNoOverlaps (return value): \n" << vaeNoOverlaps );
-            return vaeNoOverlaps;
+    nanoseconds_t earliestStartTime {UINT64_MAX};  // start with the highest value, and work downards.
+    nanoseconds_t latestEndTime {0};               //  start with the lowest value and work upwards.
 
-        }; //removeOverlaps()
+    //one allocation for the whole Station, rather than growing as we go
+    std::size_t eventCount {0};
+    for (const auto& charger : station.getChargers())
+        eventCount += charger->getAvailabilityEvents().size();
+    vaeConsolidated.reserve( eventCount );
 
-        vector<AvailabilityEvent> vaeNoOverlaps = removeOverlaps();
-        auto uptimeFraction = calculateUptime( vaeNoOverlaps, denominator );
+    //It's possible the algorithm could be made even more efficient, but let's keep it simple for future maintenance's sake
+    for (const auto& charger : station.getChargers()) {
 
-        Debug( "uptimeFraction: " << uptimeFraction << "\n" );
-        StationAvailabilityEntry entry(station->getStationID(), uptimeFraction);
-        report += entry;
+        //read the columns directly; no AvailabilityEvent is built for the downtime events
+        const AvailabilityEventStore& events = charger->getAvailabilityEvents();
+        for (std::size_t i = 0; i < events.size(); ++i) {
+            const nanoseconds_t startTime = events.startTime(i);
+            const nanoseconds_t endTime = events.endTime(i);
 
+            if (earliestStartTime > startTime )
+                earliestStartTime = startTime ;
+
+            if (latestEndTime < endTime)
+                latestEndTime = endTime;
+
+            if (events.available(i)) //we discard the downtime events
+                vaeConsolidated.emplace_back( startTime, endTime, true );
+        }
     }
 
-    report.sort(); //See Spec Section 2.3.9
-    return report;
+    Trace( MERGE, DEBUG, "station consolidated: station, available events", station.getStationID(), vaeConsolidated.size() );
 
+    const nanoseconds_t denominator = latestEndTime - earliestStartTime;
+
+    vector<AvailabilityEvent> vaeNoOverlaps = removeOverlaps( vaeConsolidated, this->sortAlgorithm );
+    auto uptimeFraction = calculateUptime( vaeNoOverlaps, denominator );
+
+    return StationAvailabilityEntry(station.getStationID(), uptimeFraction);
+}
+
+
+float StationAvailabilityReportFactory::calculateUptime( const vector<AvailabilityEvent>& vaeNoOverlaps, const nanoseconds_t denominator ) {
+    //Calculate the fraction of time that any charger at a station was available,
+    //(by adding up the time that any charger was available
+    //out of the entire time period that any charger at that station was reporting in.
+    //(known by the denominator we're passed)
+    //See Spec Section 2.3.
+    //We return the fraction as a float; callers can calculate percent by multipying by 100 as desired.
+    //This function assumes we're passed a vector with no overlapping AvailabilityEvent's. If there are
+    //overlaps, the fraction will be wrong and may even be more than 1.
+    nanoseconds_t availableDurationCumulative {0};
+    for (const auto& availabilityEvent : vaeNoOverlaps) {
+        availableDurationCumulative += (availabilityEvent.endTime - availabilityEvent.startTime);
+    }
+    const nanoseconds_t numerator = availableDurationCumulative; //superfluous, but it in code bc comments get out of synch. Compiler will remove
+    return StationAvailabilityReportFactory::uptimeFraction( numerator, denominator );
 }
 
+vector<AvailabilityEvent> StationAvailabilityReportFactory::removeOverlaps( vector<AvailabilityEvent>& vaeConsolidated, IntervalSort::Algorithm sortAlgorithm ) {
+    /*
+
+    Remove overlapping AvailabilityEvent's in vaeConsolidated and write
+    non-overlapping durations as AvailabilityEvent's to vaeNoOverlaps, which is returned.
+
+    Out strategy is to sort vaeConsolidated, iterate over it, compare the current
+    AvailabilityEvent to the previous one. According to the logic below, either
+    add the current AvailabilityEvent to vaeNoOverlaps, add a new AvailabilityEvent
+    which has its startTime reset to the previous AvailabilityEvent's endTime, or do
+    nothing.
+
+    If comparing two AvailabilityEvent's A and B, there are 5 possible cases:
+
+    Case 0:
+    A. ---------
+    B.            --------
+
+    Case 1:
+    A. --------
+    B.     -------
+    (or B starting at the same time as A, and ending later)
+
+    Case 2:
+    A.      --------
+    B. --------
+
+    Case 3:
+    A. --------------'
+    B.     ------
+
+    Case 4:
+    A.       ------
+    B.  ---------------
+
+    Bc we sort the items,  there should only be cases 0, 1, and 3. But if we handle
+    case 1 as below, that can result in there being a case 2 or 4 for following iterations.:
+    0. Add B to vaeNoOverlaps. (A is already in)
+    1, 4. Set B.start = A.end and add B.
+    2, 3. Drop B.
+
+    Case 2 only happens when A was itself trimmed by case 1 or 4, i.e. A's original start was
+    at or before B's start. So B lies inside time that is already covered and is dropped.
+    (Trimming it as in case 1 would give B.start > B.end, and a huge negative duration.)
+
+    */
+
+    //sort vaeConsolidated, move the first item to a new vector of AvailabilityEvent's: vaeNoOverlaps.
+    //Tho, if empty, return
+    //It's expensive to remove the first element, so we don't remove it.
+    //We just iterate fr the 2nd element in the for loop in next paragraph.
+    vector<AvailabilityEvent> vaeNoOverlaps;
+    if (vaeConsolidated.empty())
+        return vaeNoOverlaps;
+    IntervalSort::sort(vaeConsolidated, sortAlgorithm); //all available, so ordered by start, then end
+    vaeNoOverlaps.push_back( vaeConsolidated.at(0) );
+    if (vaeConsolidated.size() == 1) //bail if there was only one element
+        return vaeNoOverlaps;
+
+    //iterate fr the 2nd element forward, bc we already added 1st to vaeNoOverlaps
+    //in each iteration, a is the previous AvailabilityEvent. I.e., the last element in vaeNoOverlaps.
+    //b is the current AvailabilityEvent
+    for (const auto& b : std::ranges::drop_view{vaeConsolidated, 1}) {
+        const auto& a = vaeNoOverlaps.at(vaeNoOverlaps.size()-1);
+
+        if (a.endTime <= b.startTime) {
+            Trace( MERGE, VERBOSE, "overlap case", 0 );
+            // Add b
+            vaeNoOverlaps.push_back( b );
+        } else if (a.endTime > b.startTime && b.startTime >= a.startTime && a.endTime < b.endTime) {
+            Trace( MERGE, VERBOSE, "overlap case", 1 );
+            // Set b.start = a.end. Add b.
+            // The = case doesn't need to be handled here bc it was handled in 0.
+            AvailabilityEvent aeNew{ b };
+            aeNew.startTime = a.endTime;
+            if (not (aeNew.startTime == aeNew.endTime))
+                vaeNoOverlaps.push_back( aeNew );
+        } else if (a.startTime > b.startTime and a.endTime >= b.endTime) {
+            Trace( MERGE, VERBOSE, "overlap case", 2 );
+            // Dont add b. It is covered by a and whatever a was trimmed against.
+        } else if (b.startTime >= a.startTime and a.endTime >= b.endTime) {
+            Trace( MERGE, VERBOSE, "overlap case", 3 );
+            // Dont add b
+        } else if (a.startTime > b.startTime and a.endTime <= b.endTime) {
+            Trace( MERGE, VERBOSE, "overlap case", 4 );
+            // Set b.start = a.end. Add b.
+            AvailabilityEvent aeNew{ b };
+            aeNew.startTime = a.endTime;
+            if (not (aeNew.startTime == aeNew.endTime))
+                vaeNoOverlaps.push_back( aeNew );
+        } else {
+            assert(false);
+        }
+    }
+
+    Trace( MERGE, DEBUG, "overlaps removed: events, left", vaeConsolidated.size(), vaeNoOverlaps.size() );
+    return vaeNoOverlaps;
+} //removeOverlaps()
+
 
 } //namespace Availability
@@ -7,8 +7,14 @@
 #define STATIONAVAILABILITYREPORTFACTORY_H
 
 #include "StationAvailabilityReport.h"
+#include "StationAvailabilityEntry.h"
 #include "Station.h"
+#include "AvailabilityEvent.h"
+#include "IntervalSort.h"
+#include "UptimeSeriesReport.h"
+#include "RunStats.h"
 //#include "Charger.h"
+#include <functional>
 #include <memory>
 #include <map>
 
@@ -25,6 +31,9 @@ using std::map;
  *      auto factory = StationAvailabilityReportFactory(this->stations);
  *      StationAvailabilityReport report =  factory.getReport();
  *
+ * The factory borrows the container rather than copying it, so the container has to outlive the
+ * factory, and mustn't change while a report is being made.
+ *
  * Why not just pass the stations map to the StationAvailabilityReport object?
  * Well, the report doesn't need to concern itself with Stations and all of its attendant info
  * (such as each station's chargers and each charger's availability). The report only contains
@@ -34,6 +43,16 @@ using std::map;
 class StationAvailabilityReportFactory
 {
 public:
+    /**
+     * @brief How the time any Charger at a Station was available is computed.
+     * CONSOLIDATE_SORT copies the available events of all the Station's Chargers into one vector,
+     * sorts it and removes the overlaps. O(n log n).
+     * KWAY_MERGE merges each Charger's events, which are nearly always in time order already,
+     * in place. O(n log k) for k Chargers. See SortedRunMerger.
+     * Both give the same report.
+     */
+    enum class UptimeEngine { CONSOLIDATE_SORT, KWAY_MERGE };
+
     /**
      * Default constructor. C++ default.
      */
@@ -42,9 +61,17 @@ public:
     /**
      * Constructor
      *
-     * @param stations a container of Station's on which to report.
+     * @param stations a container of Station's on which to report. Borrowed, not copied.
+     * @param threadCount number of threads getReport() computes the Stations on. 1 computes them
+     * on the calling thread, 0 uses one thread per hardware thread.
+     * @param engine how each Station's available time is computed
+     * @param sortAlgorithm how events are sorted when they have to be. See IntervalSort.
+     * @param stats where getReport() records its phases. nullptr records nothing.
      */
-    StationAvailabilityReportFactory(map<ChargingNodes::stationID_t, shared_ptr<ChargingNodes::Station>> stations);
+    StationAvailabilityReportFactory(const map<ChargingNodes::stationID_t, shared_ptr<ChargingNodes::Station>>& stations, unsigned threadCount = 1,
+                                     UptimeEngine engine = UptimeEngine::KWAY_MERGE,
+                                     IntervalSort::Algorithm sortAlgorithm = IntervalSort::Algorithm::COMPARISON,
+                                     Charging::RunStats* stats = nullptr);
 
     /**
      * Copy constructor. C++ default.
@@ -70,6 +97,8 @@ public:
      * @brief Get the station availability report.
      * Returns an object which contains StationAvailabilityEntry's, which are lines of the station
      * availability report.
+     * With more than one thread, the Stations are computed in parallel, biggest first. The
+     * report is the same whatever the thread count.
      *
      * @return StationAvailabilityReport
      *
@@ -77,14 +106,112 @@ public:
      */
     StationAvailabilityReport getReport();
 
+    /**
+     * @brief The uptime fraction of a Station. See Spec Section 2.3.
+     * Every engine which computes uptime goes thru here, so that they all round the same way and
+     * their reports are byte-identical.
+     *
+     * @param numerator time during which any Charger at the Station was available
+     * @param denominator time from the Station's earliest start time to its latest end time
+     * @return float
+     */
+    static float uptimeFraction( nanoseconds_t numerator, nanoseconds_t denominator );
+
+    /**
+     * @brief The uptime fraction of a single Charger: the time it was available, divided by the
+     * time from its own earliest start time to its own latest end time.
+     * The same as the uptime of a Station with just this Charger.
+     *
+     * @param charger the Charger
+     * @return float
+     */
+    static float chargerUptimeFraction( const ChargingNodes::Charger& charger );
+
+    /**
+     * @brief The overlap removal stage of the CONSOLIDATE_SORT engine: sort a Station's available
+     * events, then trim or drop each one against those before it.
+     *
+     * @param vaeConsolidated the available events of all the Station's Chargers. Sorted in place.
+     * @param sortAlgorithm how to sort them. See IntervalSort.
+     * @return vector<AvailabilityEvent> the same time, without overlaps, in time order
+     */
+    static vector<AvailabilityEvent> removeOverlaps( vector<AvailabilityEvent>& vaeConsolidated, IntervalSort::Algorithm sortAlgorithm );
+
+    /**
+     * @brief The last stage of the CONSOLIDATE_SORT engine: add up the available time and divide.
+     *
+     * @param vaeNoOverlaps available events without overlaps, as removeOverlaps() returns them
+     * @param denominator time from the Station's earliest start time to its latest end time
+     * @return float the uptime fraction. See uptimeFraction().
+     */
+    static float calculateUptime( const vector<AvailabilityEvent>& vaeNoOverlaps, nanoseconds_t denominator );
+
+    /**
+     * @brief Get the bucketed uptime report: per Station, available and reporting time in every
+     * bucket of the given width. See UptimeSeriesReport.
+     * Each Station's series comes from one sweep over its merged available time, on threadCount
+     * threads like getReport().
+     * Throws std::length_error if the Stations' series would hold more than
+     * UptimeSeriesReport::MAX_BUCKETS buckets between them.
+     *
+     * @param bucketWidth width of a bucket, e.g. 3600'000'000'000 for an hour in nanoseconds
+     * @return UptimeSeriesReport in station ID order
+     */
+    UptimeSeriesReport getSeriesReport( nanoseconds_t bucketWidth );
+
 protected:
     /**
-     * @brief A map of Station's, keyed by station ID.
+     * @brief Compute the report entry of one Station.
+     * Reads nothing but the Station and its Chargers, so Stations can be computed concurrently.
+     *
+     * @param station the Station to report on
+     * @return StationAvailabilityEntry
+     */
+    StationAvailabilityEntry getEntry( const ChargingNodes::Station& station ) const;
+
+    /**
+     * @brief Call work(slot, station) for every Station, slot being its index in station ID order.
+     * On threadCount threads, biggest Stations first. Each call should write only to its own slot.
+     * On one thread the Stations are walked in place, without allocating.
+     *
+     * @param work the work for one Station
+     */
+    void forEachStation( const std::function<void(std::size_t, const ChargingNodes::Station&)>& work ) const;
+
+    /**
+     * @brief A map of Station's, keyed by station ID. Borrowed from whoever made the factory.
      * The need for this is that this object will iterate over its Station's, generating
      * a report of availability by station. <code>stations</code> contains all the info needed
      * for creating the report.
      */
-    map<ChargingNodes::stationID_t, shared_ptr<ChargingNodes::Station>> stations;
+    const map<ChargingNodes::stationID_t, shared_ptr<ChargingNodes::Station>>* stations {&NO_STATIONS};
+
+    /**
+     * @brief What a default-constructed factory reports on.
+     */
+    inline static const map<ChargingNodes::stationID_t, shared_ptr<ChargingNodes::Station>> NO_STATIONS {};
+
+    /**
+     * @brief Number of threads getReport() uses. At least 1.
+     */
+    unsigned threadCount {1};
+
+    /**
+     * @brief How getEntry() computes a Station's available time.
+     */
+    UptimeEngine engine {UptimeEngine::KWAY_MERGE};
+
+    /**
+     * @brief How getEntry() sorts events: all of a Station's for CONSOLIDATE_SORT, those of
+     * Chargers which aren't in order for KWAY_MERGE.
+     */
+    IntervalSort::Algorithm sortAlgorithm {IntervalSort::Algorithm::COMPARISON};
+
+    /**
+     * @brief Where getReport() records its phases: computing the Stations' uptimes, by merge or
+     * by consolidate, then sorting the report. Not owned. nullptr records nothing.
+     */
+    Charging::RunStats* stats {nullptr};
 
 };
 
@@ -0,0 +1,122 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Charging.h"
+#include "StreamingUptimeEngine.h"
+#include "StationAvailabilityEntry.h"
+#include "StationAvailabilityReportFactory.h"
+#include "ChargingNetwork.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace Charging {
+
+StreamingUptimeEngine::StreamingUptimeEngine() = default;
+
+StreamingUptimeEngine::StreamingUptimeEngine ( const StreamingUptimeEngine& other ) = default;
+
+StreamingUptimeEngine::~StreamingUptimeEngine() = default;
+
+StreamingUptimeEngine& StreamingUptimeEngine::operator= ( const StreamingUptimeEngine& other ) = default;
+
+StationAvailabilityReport StreamingUptimeEngine::run ( const std::filesystem::path& inputFile ) {
+    std::ifstream ifs {inputFile, std::ios::binary};
+    if ( !ifs.is_open() ) { //same as ChargingNetwork
+        std::cout << ChargingNetwork::ERROR_TEXT << "\n"; // See Spec Section 2.3.1
+        static const std::string explanation { "Could not open file." };
+        std::cerr << explanation << "\n"; // See Spec Section 2.3.2
+        throw std::filesystem::filesystem_error ( explanation, inputFile, std::error_code() );
+    }
+    this->consume ( ifs );
+    return this->getReport();
+}
+
+void StreamingUptimeEngine::consume ( std::istream& is ) {
+    //A block rarely ends on a newline. The unfinished line is moved to the front of the buffer
+    //and the next block is read in after it.
+    std::string buffer ( BLOCK_SIZE, '\0' );
+    std::size_t carried {0};
+
+    while ( is ) {
+        if ( carried == buffer.size() ) //a line longer than the buffer
+            buffer.resize ( buffer.size() * 2 );
+        is.read ( buffer.data() + carried, static_cast<std::streamsize> ( buffer.size() - carried ) );
+        const std::size_t filled = carried + static_cast<std::size_t> ( is.gcount() );
+
+        std::string_view bytes {buffer.data(), filled};
+        const auto lastNewline = bytes.rfind ( '\n' );
+        std::string_view complete = ( lastNewline == std::string_view::npos ) ? std::string_view {} : bytes.substr ( 0, lastNewline + 1 );
+
+        std::string_view line;
+        while ( DataFileParser::nextLine ( complete, line ) ) {
+            this->consumeLine ( line );
+        }
+
+        carried = filled - ( lastNewline == std::string_view::npos ? 0 : lastNewline + 1 );
+        std::copy ( buffer.data() + filled - carried, buffer.data() + filled, buffer.data() );
+    }
+
+    //the last line needn't end with a newline
+    if ( carried > 0 )
+        this->consumeLine ( {buffer.data(), carried} );
+}
+
+void StreamingUptimeEngine::consumeLine ( std::string_view line ) {
+    using Section = DataFileParser::Section;
+    if ( line.empty() or DataFileParser::isHeader ( line, this->section ) )
+        return;
+
+    switch ( this->section ) {
+    case Section::NONE:
+        break;
+    case Section::STATIONS: {
+        stationID_t stationID;
+        DataFileParser::parseStationsLine ( line, stationID, [&] ( chargerID_t chargerID ) {
+            //As in ChargingNetwork, a Station comes into being with its first Charger
+            const auto [station, inserted] = this->stationIndexes.try_emplace ( stationID, this->accumulators.size() );
+            if ( inserted )
+                this->accumulators.emplace_back();
+            this->chargerIDs.push_back ( chargerID );
+            this->chargerStations.push_back ( station->second );
+            this->chargerIndexStale = true;
+        } );
+    }
+        break;
+    case Section::AVAILABILITY_REPORTS: {
+        DataFileParser::AvailabilityRecord record;
+        if ( not DataFileParser::parseAvailabilityLine ( line, record ) )
+            break;
+        if ( this->chargerIndexStale ) { //the topology is complete
+            this->chargerIndex = DenseIdMap ( this->chargerIDs );
+            this->chargerIndexStale = false;
+        }
+        const uint32_t charger = this->chargerIndex.find ( record.chargerID );
+        if ( charger == DenseIdMap::NOT_FOUND ) //not a Charger listed under [Stations]
+            break;
+        DataFileParser::clampEndTime ( record.startTime, record.endTime );
+
+        auto& accumulator = this->accumulators[this->chargerStations[charger]];
+        accumulator.earliestStartTime = std::min ( accumulator.earliestStartTime, record.startTime );
+        accumulator.latestEndTime = std::max ( accumulator.latestEndTime, record.endTime );
+        if ( record.available ) //downtime only counts towards the denominator
+            accumulator.available.insert ( record.startTime, record.endTime );
+    }
+        break;
+    }
+}
+
+StationAvailabilityReport StreamingUptimeEngine::getReport() const {
+    StationAvailabilityReport report;
+    for ( const auto& [stationID, index] : this->stationIndexes ) { //in station ID order. See Spec Section 2.3.9
+        const auto& accumulator = this->accumulators[index];
+        const nanoseconds_t denominator = accumulator.latestEndTime - accumulator.earliestStartTime;
+        report += Availability::StationAvailabilityEntry ( stationID,
+            Availability::StationAvailabilityReportFactory::uptimeFraction ( accumulator.available.coveredLength(), denominator ) );
+    }
+    return report;
+}
+
+} //namespace Charging
@@ -0,0 +1,163 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+#ifndef STREAMINGUPTIMEENGINE_H
+#define STREAMINGUPTIMEENGINE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <istream>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "AvailabilityEvent.h"
+#include "Charger.h"
+#include "DataFileParser.h"
+#include "DenseIdMap.h"
+#include "IntervalUnion.h"
+#include "Station.h"
+#include "StationAvailabilityReport.h"
+
+namespace Charging {
+using Availability::IntervalUnion;
+using Availability::StationAvailabilityReport;
+
+/**
+ * @brief Computes the station availability report in a single pass over the input data file,
+ * without building a ChargingNetwork.
+ * See Spec Section 2.3.
+ *
+ * Only the topology is kept (which Station each Charger reports for) plus, per Station, a running
+ * IntervalUnion of its available time and the earliest start and latest end time seen so far.
+ * Each [Charger Availability Reports] line is folded into its Station's accumulator as soon as it
+ * is read and then forgotten. Memory therefore grows with the number of Stations (and the gaps in
+ * their availability), not with the number of events, and the file is read in fixed-size blocks.
+ *
+ * The report is identical to ChargingNetwork::getStationAvailabilityReport() for the same file.
+ *
+ *      StreamingUptimeEngine engine;
+ *      StationAvailabilityReport report = engine.run ( "/path/to/data/file" );
+ *      cout << report;
+ *
+ * Data can also be fed in by hand, a line or a block at a time, e.g. as it arrives.
+ */
+class StreamingUptimeEngine
+{
+public:
+    /**
+     * Default constructor. C++ default.
+     */
+    StreamingUptimeEngine();
+
+    /**
+     * Copy constructor. C++ default.
+     *
+     * @param other object to copy
+     */
+    StreamingUptimeEngine ( const StreamingUptimeEngine& other );
+
+    /**
+     * Destructor. C++ default.
+     */
+    ~StreamingUptimeEngine();
+
+    /**
+     * Assignment operator. C++ default.
+     *
+     * @param other object to copy from
+     * @return object reference
+     */
+    StreamingUptimeEngine& operator= ( const StreamingUptimeEngine& other );
+
+    /**
+     * @brief Read a whole input data file and return its report.
+     * Throws std::filesystem::filesystem_error if the file can't be opened, after printing ERROR
+     * as ChargingNetwork does. See Spec Section 2.3.1.
+     *
+     * @param inputFile The path to the input data file
+     * @return StationAvailabilityReport
+     */
+    StationAvailabilityReport run ( const std::filesystem::path& inputFile );
+
+    /**
+     * @brief Read an input data stream to its end, in blocks.
+     *
+     * @param is the stream to read
+     */
+    void consume ( std::istream& is );
+
+    /**
+     * @brief Fold one line of the input data file into the accumulators.
+     *
+     * @param line the line, without its newline
+     */
+    void consumeLine ( std::string_view line );
+
+    /**
+     * @brief The report for everything consumed so far.
+     *
+     * @return StationAvailabilityReport
+     */
+    StationAvailabilityReport getReport() const;
+
+protected:
+    /**
+     * @brief Running totals for one Station.
+     */
+    struct StationAccumulator {
+        /**
+         * @brief Union of the time any Charger at the Station was available.
+         */
+        IntervalUnion available;
+        /**
+         * @brief Earliest start time of any event at the Station, available or not.
+         */
+        nanoseconds_t earliestStartTime {UINT64_MAX};
+        /**
+         * @brief Latest end time of any event at the Station, available or not.
+         */
+        nanoseconds_t latestEndTime {0};
+    };
+
+    /**
+     * @brief Bytes read from a stream at a time.
+     */
+    static constexpr std::size_t BLOCK_SIZE {1 << 20};
+
+    /**
+     * @brief One accumulator per Station, in the order the Stations were first listed.
+     */
+    std::vector<StationAccumulator> accumulators;
+
+    /**
+     * @brief Index into accumulators, keyed by station ID. Sorted, so the report comes out in order.
+     */
+    std::map<stationID_t, std::size_t> stationIndexes;
+
+    /**
+     * @brief Every chargerID under [Stations], in the order listed, and the index into
+     * accumulators of its Station.
+     */
+    std::vector<chargerID_t> chargerIDs;
+    std::vector<std::size_t> chargerStations;
+
+    /**
+     * @brief chargerID to index into chargerIDs, built from them when the availability reports
+     * start. A Charger listed under more than one Station reports for the first, as in
+     * ChargingNetwork.
+     */
+    DenseIdMap chargerIndex;
+    bool chargerIndexStale {false};
+
+    /**
+     * @brief The section of the input data file we're in.
+     */
+    DataFileParser::Section section {DataFileParser::Section::NONE};
+};
+
+} //namespace Charging
+
+#endif // STREAMINGUPTIMEENGINE_H
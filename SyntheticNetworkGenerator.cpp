@@ -0,0 +1,245 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "SyntheticNetworkGenerator.h"
+
+#include "Benchmarking.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Charging {
+using std::vector;
+
+std::size_t SyntheticNetworkGenerator::parseCount ( const std::string& text ) {
+    std::size_t suffix {0};
+    const double value = std::stod ( text, &suffix );
+    double multiplier {1};
+    if ( suffix < text.size() ) {
+        if ( suffix + 1 != text.size() ) //one suffix letter, and nothing after it
+            throw std::invalid_argument ( text );
+        switch ( text[suffix] ) {
+        case 'K': case 'k': multiplier = 1e3; break;
+        case 'M': case 'm': multiplier = 1e6; break;
+        case 'G': case 'g': multiplier = 1e9; break;
+        default: throw std::invalid_argument ( text );
+        }
+    }
+    //not ( > 0 ) catches NaN too; past 2^63 the cast to size_t isn't defined
+    if ( not ( value * multiplier >= 1 ) or value * multiplier >= 0x1p63 )
+        throw std::out_of_range ( text );
+    return static_cast<std::size_t> ( value * multiplier );
+}
+
+namespace {
+
+/**
+ * @brief The draws the generator needs, from SplitMix64, so every number is the same everywhere.
+ */
+class Random
+{
+public:
+    explicit Random ( uint64_t seed ) : generator {seed} {}
+
+    uint64_t next() noexcept { return this->generator.next(); }
+
+    /**
+     * @brief A number from 0 to bound - 1. bound must be greater than 0.
+     */
+    uint64_t below ( uint64_t bound ) noexcept { return this->next() % bound; }
+
+    /**
+     * @brief A number in (0, 1].
+     */
+    double unit() noexcept { return static_cast<double> ( ( this->next() >> 11 ) + 1 ) * 0x1p-53; }
+
+    bool chance ( double probability ) noexcept { return this->unit() <= probability; }
+
+private:
+    SplitMix64 generator;
+};
+
+/**
+ * @brief The cube root of value, rounded down. In integers, so that it's the same everywhere;
+ * std::cbrt and std::pow can round differently from one libm to the next.
+ */
+uint64_t cubeRoot ( uint64_t value ) noexcept {
+    static constexpr uint64_t LARGEST {2642245}; //the largest whose cube fits in 64 bits
+    uint64_t root {0};
+    for ( int bit = 21; bit >= 0; --bit ) {
+        const uint64_t candidate = root | ( uint64_t {1} << bit );
+        if ( candidate <= LARGEST and candidate * candidate * candidate <= value )
+            root = candidate;
+    }
+    return root;
+}
+
+/**
+ * @brief One line of the data file, formatted. The longest, an availability report with 20 digit
+ * times, is 59 characters.
+ */
+class Line
+{
+public:
+    void append ( uint64_t value ) noexcept {
+        this->size = std::to_chars ( this->text.data() + this->size, this->text.data() + this->text.size(), value ).ptr - this->text.data();
+    }
+    void append ( std::string_view chars ) noexcept {
+        std::ranges::copy ( chars, this->text.begin() + this->size );
+        this->size += chars.size();
+    }
+    void append ( char c ) noexcept { this->text[this->size++] = c; }
+
+    std::string_view view() const noexcept { return {this->text.data(), this->size}; }
+
+private:
+    std::array<char, 64> text;
+    std::size_t size {0};
+};
+
+//Roughly now, in nanoseconds since the epoch, as the reports from a live network would be
+constexpr uint64_t BASE_TIME {1'700'000'000'000'000'000u};
+//Each report covers one minute to one hour
+constexpr uint64_t MIN_DURATION {60'000'000'000u};
+constexpr uint64_t MAX_DURATION {3600'000'000'000u};
+
+} //namespace
+
+SyntheticNetworkGenerator::SyntheticNetworkGenerator() = default;
+
+SyntheticNetworkGenerator::SyntheticNetworkGenerator ( const Options& options ) : options {options} {
+}
+
+SyntheticNetworkGenerator::SyntheticNetworkGenerator ( const SyntheticNetworkGenerator& other ) = default;
+
+SyntheticNetworkGenerator::~SyntheticNetworkGenerator() = default;
+
+SyntheticNetworkGenerator& SyntheticNetworkGenerator::operator= ( const SyntheticNetworkGenerator& other ) = default;
+
+void SyntheticNetworkGenerator::write ( std::ostream& os ) const {
+    Random random {this->options.seed};
+    const uint32_t mean = std::max<uint32_t> ( this->options.chargersPerStation, 1 );
+
+    //Written a megabyte at a time, rather than a line at a time thru the stream
+    static constexpr std::size_t FLUSH_SIZE {1 << 20};
+    std::string out;
+    out.reserve ( FLUSH_SIZE + 256 );
+    auto flushIfFull = [&] () {
+        if ( out.size() >= FLUSH_SIZE ) {
+            os.write ( out.data(), static_cast<std::streamsize> ( out.size() ) );
+            out.clear();
+        }
+    };
+    auto separator = [&] () {
+        switch ( this->options.whitespace ) {
+        case Whitespace::SPACES:
+            return ' ';
+        case Whitespace::TABS:
+            return '\t';
+        case Whitespace::MIXED:
+            break;
+        }
+        return random.chance ( 0.5 ) ? '\t' : ' ';
+    };
+    auto append = [&out] ( uint64_t value ) {
+        char digits[20];
+        out.append ( digits, std::to_chars ( digits, digits + sizeof digits, value ).ptr );
+    };
+
+    //[Stations]
+    out += "[Stations]\n";
+    uint32_t chargerCount {0};
+    for ( uint32_t station = 0; station < this->options.stationCount; ++station ) {
+        uint64_t chargers {mean};
+        if ( this->options.distribution == ChargerDistribution::UNIFORM ) {
+            chargers = 1 + random.below ( 2 * uint64_t {mean} - 1 );
+        } else if ( this->options.distribution == ChargerDistribution::SKEWED ) {
+            //Pareto with shape 1.5, scale / u^(2/3), whose mean is 3 times its scale. Worked out
+            //in integers: u in (0, 1] in steps of 2^-21, and u^(-2/3) in steps of 2^-7, the cube
+            //root of 2^63 / u^2 with u counted in steps. Capped, so that a freak draw can't run
+            //away with the file.
+            const uint64_t u = ( random.next() >> 43 ) + 1;
+            const uint64_t multiplier = cubeRoot ( ( uint64_t {1} << 63 ) / ( u * u ) );
+            chargers = std::clamp<uint64_t> ( mean * multiplier / ( 3 << 7 ), 1, uint64_t {mean} * 1000 );
+        }
+        const char sep = separator();
+        append ( station );
+        for ( uint64_t i = 0; i < chargers; ++i ) {
+            out += sep;
+            append ( 1000 + uint64_t {chargerCount++} );
+        }
+        out += '\n';
+        flushIfFull();
+    }
+
+    //[Charger Availability Reports]
+    out += "\n[Charger Availability Reports]\n";
+    vector<uint64_t> clocks ( chargerCount );
+    vector<uint64_t> lastDurations ( chargerCount, 0 );
+    for ( auto& clock : clocks ) //staggered, so the Chargers don't all report at the same moment
+        clock = BASE_TIME + random.below ( MAX_DURATION );
+
+    vector<Line> heldBack;
+    heldBack.reserve ( REORDER_WINDOW );
+    auto emit = [&] ( Line line ) {
+        if ( this->options.sortedness < 1.0 and random.chance ( 1.0 - this->options.sortedness ) ) {
+            if ( heldBack.size() == REORDER_WINDOW ) {
+                //out it goes at a random point, then, and this one takes its place
+                std::swap ( heldBack[random.below ( REORDER_WINDOW )], line );
+                out += line.view();
+                flushIfFull();
+                return;
+            }
+            heldBack.push_back ( line );
+            return;
+        }
+        out += line.view();
+        flushIfFull();
+    };
+
+    for ( uint32_t event = 0; event < this->options.eventsPerCharger; ++event ) {
+        for ( uint32_t charger = 0; charger < chargerCount; ++charger ) {
+            const uint64_t duration = MIN_DURATION + random.below ( MAX_DURATION - MIN_DURATION );
+            uint64_t& clock = clocks[charger];
+            uint64_t start = clock;
+            if ( lastDurations[charger] > 0 and random.chance ( this->options.overlapRate ) ) {
+                start -= 1 + random.below ( lastDurations[charger] ); //never before the previous start
+            } else if ( random.chance ( 0.5 ) ) {
+                start += random.below ( duration ); //a gap
+            }
+            const uint64_t end = start + duration;
+            clock = std::max ( clock, end );
+            lastDurations[charger] = duration;
+
+            Line line;
+            const char sep = separator();
+            line.append ( 1000 + uint64_t {charger} );
+            line.append ( sep );
+            line.append ( start );
+            line.append ( sep );
+            line.append ( end );
+            line.append ( sep );
+            line.append ( random.chance ( this->options.uptime ) ? "true\n" : "false\n" );
+
+            emit ( line );
+            if ( random.chance ( this->options.duplicateRate ) )
+                emit ( line );
+        }
+    }
+
+    //what's still held back goes at the end, in random order
+    for ( std::size_t i = heldBack.size(); i > 1; --i )
+        std::swap ( heldBack[i - 1], heldBack[random.below ( i )] );
+    for ( const auto& line : heldBack ) {
+        out += line.view();
+        flushIfFull();
+    }
+    os.write ( out.data(), static_cast<std::streamsize> ( out.size() ) );
+}
+
+} //namespace Charging
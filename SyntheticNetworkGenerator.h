@@ -0,0 +1,132 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+#ifndef SYNTHETICNETWORKGENERATOR_H
+#define SYNTHETICNETWORKGENERATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace Charging {
+
+/**
+ * @brief Writes input data files of any size, for benchmarks and scaling tests. See Spec Section 2.1.
+ *
+ * Everything about the file comes from the Options, including the seed of the random numbers, so
+ * the same Options give the same file, byte for byte, on any platform: the numbers are drawn
+ * from SplitMix64 and worked with in integers, or in doubles only where the result is exact.
+ *
+ *      SyntheticNetworkGenerator::Options options;
+ *      options.stationCount = 10000;
+ *      options.distribution = SyntheticNetworkGenerator::ChargerDistribution::SKEWED;
+ *      std::ofstream ofs {"/tmp/big.txt"};
+ *      SyntheticNetworkGenerator {options}.write ( ofs );
+ *
+ * Station IDs are 0 up, charger IDs 1000 up. Each Charger reports eventsPerCharger times, one
+ * report after the other: back to back, or with a gap, or (overlapRate) starting before the
+ * previous one ended. The reports are written round robin over the Chargers, so the section is
+ * in time order, give or take, unless sortedness says otherwise.
+ */
+class SyntheticNetworkGenerator
+{
+public:
+    /**
+     * @brief How many Chargers each Station gets.
+     * FIXED gives every Station chargersPerStation.
+     * UNIFORM gives each one 1 to 2 * chargersPerStation - 1, evenly spread.
+     * SKEWED draws from a Pareto distribution with mean chargersPerStation: most Stations have a
+     * few Chargers, and a few depots have hundreds of times as many.
+     */
+    enum class ChargerDistribution { FIXED, UNIFORM, SKEWED };
+
+    /**
+     * @brief What separates the fields of a line. MIXED picks tabs or spaces line by line, as in
+     * input_3.txt.
+     */
+    enum class Whitespace { SPACES, TABS, MIXED };
+
+    struct Options {
+        uint64_t seed {1};
+        uint32_t stationCount {100};
+        uint32_t chargersPerStation {4};            ///< at least 1. The mean, for UNIFORM and SKEWED.
+        ChargerDistribution distribution {ChargerDistribution::FIXED};
+        uint32_t eventsPerCharger {100};
+        double overlapRate {0.05};      ///< chance a report overlaps the Charger's previous one
+        double duplicateRate {0.01};    ///< chance a report is retransmitted: written twice
+        double sortedness {1.0};        ///< 1 writes the reports in time order; less holds some back, 0 all
+        double uptime {0.9};            ///< chance a report says the Charger was available
+        Whitespace whitespace {Whitespace::SPACES};
+    };
+
+    /**
+     * @brief Most reports held back at once when sortedness is below 1. A held back report is
+     * written at a random point later, so this is about how far out of order reports get.
+     */
+    static constexpr std::size_t REORDER_WINDOW {4096};
+
+    /**
+     * Default constructor. Default Options.
+     */
+    SyntheticNetworkGenerator();
+
+    /**
+     * @brief Constructor.
+     *
+     * @param options what to generate
+     */
+    explicit SyntheticNetworkGenerator ( const Options& options );
+
+    /**
+     * Copy constructor. C++ default.
+     *
+     * @param other the object being copied from
+     */
+    SyntheticNetworkGenerator ( const SyntheticNetworkGenerator& other );
+
+    /**
+     * Destructor. C++ default.
+     */
+    ~SyntheticNetworkGenerator();
+
+    /**
+     * Assignment operator. C++ default.
+     *
+     * @param other the object being copied from
+     * @return SyntheticNetworkGenerator&
+     */
+    SyntheticNetworkGenerator& operator= ( const SyntheticNetworkGenerator& other );
+
+    /**
+     * @brief Write the whole data file.
+     *
+     * @param os where to write it
+     */
+    void write ( std::ostream& os ) const;
+
+    /**
+     * @brief The Options the file is generated from.
+     *
+     * @return const Options&
+     */
+    const Options& getOptions() const noexcept { return this->options; }
+
+    /**
+     * @brief Parse a count such as 512, 16K, 64M or 1G (powers of 1000), as electra2_bench and
+     * electra2_sweep take sizes and event counts.
+     * Throws std::invalid_argument if text isn't one, and std::out_of_range if it isn't above 0.
+     *
+     * @param text the count
+     * @return std::size_t
+     */
+    static std::size_t parseCount ( const std::string& text );
+
+protected:
+    Options options;
+};
+
+} //namespace Charging
+
+#endif // SYNTHETICNETWORKGENERATOR_H
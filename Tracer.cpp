@@ -0,0 +1,219 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Tracer.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <deque>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Charging {
+
+namespace {
+
+/**
+ * @brief A single-producer, single-consumer ring of Records. Only its owning thread pushes, only
+ * the Session's thread drains. head and tail only ever grow; the slot is the count modulo the
+ * capacity.
+ */
+class Ring
+{
+public:
+    explicit Ring ( uint32_t threadNumber ) : threadNumber {threadNumber} {}
+
+    void push ( const Tracer::Record& record ) noexcept {
+        const uint64_t head = this->head.load ( std::memory_order_relaxed );
+        if ( head - this->tail.load ( std::memory_order_acquire ) == Tracer::RING_CAPACITY ) {
+            this->dropped.fetch_add ( 1, std::memory_order_relaxed );
+            return;
+        }
+        this->records[head % Tracer::RING_CAPACITY] = record;
+        this->head.store ( head + 1, std::memory_order_release );
+    }
+
+    /**
+     * @brief Move every record pushed so far to out.
+     */
+    void drain ( std::vector<std::pair<uint32_t, Tracer::Record>>& out ) {
+        const uint64_t tail = this->tail.load ( std::memory_order_relaxed );
+        const uint64_t head = this->head.load ( std::memory_order_acquire );
+        for ( uint64_t i = tail; i < head; ++i )
+            out.emplace_back ( this->threadNumber, this->records[i % Tracer::RING_CAPACITY] );
+        this->tail.store ( head, std::memory_order_release );
+    }
+
+    const uint32_t threadNumber;
+    std::atomic<bool> owned {true};
+    std::atomic<uint64_t> dropped {0};
+
+private:
+    std::array<Tracer::Record, Tracer::RING_CAPACITY> records;
+    alignas ( 64 ) std::atomic<uint64_t> head {0};
+    alignas ( 64 ) std::atomic<uint64_t> tail {0};
+};
+
+/**
+ * @brief Every ring there is. Rings are never freed: a thread which ends gives its ring up, and
+ * the next new thread takes it over.
+ */
+struct Rings {
+    std::mutex mutex;
+    std::deque<Ring> rings;
+};
+
+Rings& allRings() {
+    static Rings rings;
+    return rings;
+}
+
+/**
+ * @brief The calling thread's ring. Given up when the thread ends.
+ */
+struct ThreadRing {
+    Ring* ring {nullptr};
+    ~ThreadRing() {
+        if ( this->ring != nullptr )
+            this->ring->owned.store ( false, std::memory_order_release );
+    }
+};
+thread_local ThreadRing threadRing;
+
+Ring& claimRing() {
+    Rings& rings = allRings();
+    std::lock_guard lock {rings.mutex};
+    for ( auto& ring : rings.rings ) {
+        bool owned {false};
+        if ( ring.owned.compare_exchange_strong ( owned, true, std::memory_order_acquire ) )
+            return ring;
+    }
+    return rings.rings.emplace_back ( static_cast<uint32_t> ( rings.rings.size() + 1 ) );
+}
+
+/**
+ * @brief When the current Session started, in steady_clock ticks.
+ */
+int64_t sessionStart {0};
+
+constexpr std::string_view CATEGORY_NAMES[] {"parse", "merge", "report"};
+constexpr std::string_view LEVEL_NAMES[] {"", "info", "debug", "verbose"};
+
+/**
+ * @brief Drain every ring and write what was in them, in time order.
+ *
+ * @return false if there was nothing
+ */
+bool drainAll ( std::ostream& sink ) {
+    std::vector<std::pair<uint32_t, Tracer::Record>> records;
+    {
+        Rings& rings = allRings();
+        std::lock_guard lock {rings.mutex};
+        for ( auto& ring : rings.rings )
+            ring.drain ( records );
+    }
+    if ( records.empty() )
+        return false;
+    std::ranges::stable_sort ( records, {}, [] ( const auto& threadRecord ) { return threadRecord.second.time; } );
+
+    std::string text;
+    text.reserve ( records.size() * 64 );
+    char number[24];
+    auto appendNumber = [&text, &number] ( auto value ) {
+        text.append ( number, std::to_chars ( number, number + sizeof number, value ).ptr );
+    };
+    for ( const auto& [threadNumber, record] : records ) {
+        const auto sinceStart = std::chrono::steady_clock::duration ( record.time - sessionStart );
+        const auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds> ( sinceStart ).count();
+        appendNumber ( nanoseconds / 1'000'000'000 );
+        text += '.';
+        const auto fraction = nanoseconds % 1'000'000'000;
+        for ( int64_t digit = 100'000'000; digit > 0; digit /= 10 )
+            text += static_cast<char> ( '0' + fraction / digit % 10 );
+        text += ' ';
+        appendNumber ( threadNumber );
+        text += ' ';
+        text += CATEGORY_NAMES[static_cast<std::size_t> ( record.category )];
+        text += ' ';
+        text += LEVEL_NAMES[static_cast<std::size_t> ( record.level )];
+        text += ' ';
+        text += record.message;
+        for ( uint8_t i = 0; i < record.valueCount; ++i ) {
+            text += ( i == 0 ) ? ": " : " ";
+            appendNumber ( record.values[i] );
+        }
+        text += '\n';
+    }
+    sink.write ( text.data(), static_cast<std::streamsize> ( text.size() ) );
+    return true;
+}
+
+} //namespace
+
+void Tracer::push ( const Record& record ) noexcept {
+    if ( threadRing.ring == nullptr )
+        threadRing.ring = &claimRing();
+    threadRing.ring->push ( record );
+}
+
+Tracer::Session::Session ( std::ostream& sink ) : sink {&sink} {
+    this->start();
+}
+
+Tracer::Session::Session ( const std::filesystem::path& traceFile ) : sink {&std::cerr} {
+    if ( traceFile != "-" ) {
+        this->file = std::make_unique<std::ofstream> ( traceFile, std::ios::trunc );
+        if ( not this->file->is_open() )
+            throw std::filesystem::filesystem_error ( "Could not open trace file", traceFile, std::error_code {} );
+        this->sink = this->file.get();
+    }
+    this->start();
+}
+
+void Tracer::Session::start() {
+    if ( Tracer::active.exchange ( true ) )
+        throw std::logic_error ( "A trace session is already running" );
+    sessionStart = std::chrono::steady_clock::now().time_since_epoch().count();
+    this->drainer = std::thread ( &Session::run, this );
+}
+
+Tracer::Session::~Session() {
+    {
+        std::lock_guard lock {this->mutex};
+        this->stopping = true;
+    }
+    this->wake.notify_one();
+    this->drainer.join();
+    Tracer::active.store ( false );
+    drainAll ( *this->sink ); //whatever came in while stopping
+
+    uint64_t dropped {0};
+    Rings& rings = allRings();
+    {
+        std::lock_guard lock {rings.mutex};
+        for ( auto& ring : rings.rings )
+            dropped += ring.dropped.exchange ( 0 );
+    }
+    if ( dropped > 0 )
+        *this->sink << "dropped " << dropped << " records\n";
+    this->sink->flush();
+}
+
+void Tracer::Session::run() {
+    //Drain again straight away while there's plenty coming in, so the rings don't fill up
+    static constexpr std::chrono::milliseconds IDLE_WAIT {10};
+    std::unique_lock lock {this->mutex};
+    while ( not this->stopping ) {
+        lock.unlock();
+        const bool drained = drainAll ( *this->sink );
+        lock.lock();
+        if ( not drained )
+            this->wake.wait_for ( lock, IDLE_WAIT, [this] () { return this->stopping; } );
+    }
+}
+
+} //namespace Charging
@@ -0,0 +1,190 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <thread>
+
+/**
+ * Compile-time trace settings. Pass them to the compiler (-DELECTRA2_TRACE_LEVEL=3) or to cmake
+ * (cmake -DELECTRA2_TRACE_LEVEL=3).
+ *
+ * ELECTRA2_TRACE_LEVEL is the most detailed Tracer::Level compiled in: 0 compiles tracing out
+ * entirely, 3 keeps every Trace(). Release builds (NDEBUG) default to 0, Debug builds to 3.
+ * ELECTRA2_TRACE_CATEGORIES is a mask of the Tracer::Category's compiled in, bit n for category n.
+ */
+#ifndef ELECTRA2_TRACE_LEVEL
+#ifdef NDEBUG
+#define ELECTRA2_TRACE_LEVEL 0
+#else
+#define ELECTRA2_TRACE_LEVEL 3
+#endif
+#endif
+
+#ifndef ELECTRA2_TRACE_CATEGORIES
+#define ELECTRA2_TRACE_CATEGORIES 0x7
+#endif
+
+namespace Charging {
+
+/**
+ * @brief Structured tracing, cheap enough to leave in the parse and merge loops.
+ *
+ * Code traces with the Trace() macro: a category, a level, a message which is a string literal,
+ * and up to two integers.
+ *
+ *      Trace( PARSE, VERBOSE, "availability report", record.chargerID, record.startTime );
+ *
+ * Nothing is formatted where the trace is made. The record (a timestamp, a pointer to the
+ * message and the integers) goes into a ring buffer of the calling thread, which only that thread
+ * writes, so there are no locks and no sharing between threads. A Session drains the rings on
+ * its own thread, formats the records, and writes them to its sink, never to stdout:
+ *
+ *      0.000123456 1 parse verbose availability report: 1001 1700000000000
+ *
+ * seconds since the Session started, the thread's number, category, level, message and values.
+ * A ring which fills up faster than it's drained drops records rather than wait; the Session
+ * writes how many were dropped when it ends.
+ *
+ * Without a Session a Trace() costs a relaxed load of a flag. With ELECTRA2_TRACE_LEVEL 0, or a
+ * level or category that isn't compiled in, it costs nothing at all: it and its arguments are
+ * compiled out.
+ */
+class Tracer
+{
+public:
+    /**
+     * @brief How detailed a trace is.
+     * INFO once per run or phase, DEBUG once per Station, chunk or section, VERBOSE once per line
+     * or event.
+     */
+    enum class Level : uint8_t { INFO = 1, DEBUG = 2, VERBOSE = 3 };
+
+    /**
+     * @brief What a trace is about: reading the data file, merging and sorting events, or making
+     * the report.
+     */
+    enum class Category : uint8_t { PARSE = 0, MERGE = 1, REPORT = 2 };
+
+    /**
+     * @brief Whether traces of this category and level are compiled in.
+     */
+    static constexpr bool compiledIn ( Category category, Level level ) noexcept {
+        return static_cast<int> ( level ) <= ELECTRA2_TRACE_LEVEL
+               and ( ELECTRA2_TRACE_CATEGORIES & ( 1u << static_cast<unsigned> ( category ) ) ) != 0;
+    }
+
+    /**
+     * @brief One trace, as it sits in a ring.
+     */
+    struct Record {
+        int64_t time {0};               ///< steady_clock ticks
+        const char* message {nullptr};  ///< a string literal
+        uint64_t values[2] {};
+        uint8_t valueCount {0};
+        Category category {Category::PARSE};
+        Level level {Level::INFO};
+    };
+
+    /**
+     * @brief Records each thread's ring holds before it drops.
+     */
+    static constexpr std::size_t RING_CAPACITY {1 << 16};
+
+    /**
+     * @brief Drains the rings of every thread to a sink, for as long as it exists. One at a time.
+     */
+    class Session
+    {
+    public:
+        /**
+         * @brief Constructor. Starts tracing.
+         * Throws std::logic_error if there's already a Session.
+         *
+         * @param sink where the records go. Must outlive the Session.
+         */
+        explicit Session ( std::ostream& sink );
+
+        /**
+         * @brief Constructor. Starts tracing to a file.
+         * Throws std::filesystem::filesystem_error if the file can't be opened.
+         *
+         * @param traceFile the file, truncated. "-" is stderr.
+         */
+        explicit Session ( const std::filesystem::path& traceFile );
+
+        /**
+         * Destructor. Stops tracing, drains what's left and writes how many records were dropped.
+         */
+        ~Session();
+
+        Session ( const Session& other ) = delete;
+        Session& operator= ( const Session& other ) = delete;
+
+    protected:
+        /**
+         * @brief Start tracing, and the draining thread.
+         */
+        void start();
+
+        /**
+         * @brief The draining thread: drains, and if there was nothing, waits a while.
+         */
+        void run();
+
+        std::unique_ptr<std::ofstream> file;
+        std::ostream* sink;
+        std::mutex mutex;
+        std::condition_variable wake;
+        bool stopping {false};
+        std::thread drainer;
+    };
+
+    /**
+     * @brief Add a record to the calling thread's ring. Use Trace() instead, which compiles out.
+     */
+    template<std::size_t N, std::integral... Values> requires ( sizeof... ( Values ) <= 2 )
+    static void record ( Category category, Level level, const char ( &message ) [N], Values... values ) noexcept {
+        if ( not active.load ( std::memory_order_relaxed ) )
+            return;
+        Record record {std::chrono::steady_clock::now().time_since_epoch().count(), message,
+                       {static_cast<uint64_t> ( values )...}, sizeof... ( Values ), category, level};
+        push ( record );
+    }
+
+private:
+    static void push ( const Record& record ) noexcept;
+
+    inline static std::atomic<bool> active {false};
+};
+
+} //namespace Charging
+
+/**
+ * Trace( category, level, message, values... ): see Tracer. category is PARSE, MERGE or REPORT,
+ * level INFO, DEBUG or VERBOSE. The arguments aren't evaluated unless the trace is compiled in.
+ */
+#if ELECTRA2_TRACE_LEVEL > 0
+#define Trace(category, level, ...) \
+    do { \
+        if constexpr ( ::Charging::Tracer::compiledIn ( ::Charging::Tracer::Category::category, ::Charging::Tracer::Level::level ) ) \
+            ::Charging::Tracer::record ( ::Charging::Tracer::Category::category, ::Charging::Tracer::Level::level, __VA_ARGS__ ); \
+    } while ( false )
+#else
+#define Trace(category, level, ...) do {} while ( false )
+#endif
+
+#endif // TRACER_H
@@ -0,0 +1,101 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "UptimeIndex.h"
+#include "Charger.h"
+#include "SortedRunMerger.h"
+#include "StationAvailabilityEntry.h"
+#include "StationAvailabilityReportFactory.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace Availability {
+
+namespace {
+
+void checkWindow ( nanoseconds_t windowStart, nanoseconds_t windowEnd ) {
+    if ( windowStart >= windowEnd )
+        throw std::invalid_argument ( "Empty or reversed window: " + std::to_string ( windowStart ) + " " + std::to_string ( windowEnd ) );
+}
+
+} //namespace
+
+shared_ptr<const UptimeIndex> UptimeIndex::Cache::get ( const map<ChargingNodes::stationID_t, shared_ptr<ChargingNodes::Station>>& stations ) {
+    std::lock_guard lock {this->mutex};
+    if ( not this->index )
+        this->index = std::make_shared<const UptimeIndex> ( stations );
+    return this->index;
+}
+
+void UptimeIndex::Cache::reset() {
+    std::lock_guard lock {this->mutex};
+    this->index.reset();
+}
+
+UptimeIndex::UptimeIndex() = default;
+
+UptimeIndex::UptimeIndex ( const map<ChargingNodes::stationID_t, shared_ptr<ChargingNodes::Station>>& stations ) {
+    this->stations.reserve ( stations.size() );
+    for ( const auto& [stationID, station] : stations ) {
+        StationIndex& index = this->stations.emplace_back();
+        index.stationID = stationID;
+
+        SortedRunMerger merger;
+        for ( const auto& charger : station->chargers ) {
+            merger.addRun ( charger->availabilityEvents );
+        }
+        index.earliestStartTime = merger.earliestStartTime();
+        index.latestEndTime = merger.latestEndTime();
+
+        const auto merged = merger.mergedIntervals();
+        index.startTimes.reserve ( merged.size() );
+        index.endTimes.reserve ( merged.size() );
+        index.availableBefore.reserve ( merged.size() );
+        nanoseconds_t total {0};
+        for ( const auto& interval : merged ) {
+            index.startTimes.push_back ( interval.startTime );
+            index.endTimes.push_back ( interval.endTime );
+            index.availableBefore.push_back ( total );
+            total += interval.endTime - interval.startTime;
+        }
+    }
+}
+
+nanoseconds_t UptimeIndex::StationIndex::availableUntil ( nanoseconds_t t ) const {
+    //the last interval starting before t is the only one t can fall inside
+    const auto after = std::ranges::upper_bound ( this->startTimes, t );
+    if ( after == this->startTimes.begin() )
+        return 0;
+    const std::size_t i = static_cast<std::size_t> ( after - this->startTimes.begin() ) - 1;
+    return this->availableBefore[i] + std::min ( t, this->endTimes[i] ) - this->startTimes[i];
+}
+
+std::optional<float> UptimeIndex::StationIndex::uptime ( nanoseconds_t windowStart, nanoseconds_t windowEnd ) const {
+    const nanoseconds_t from = std::max ( windowStart, this->earliestStartTime );
+    const nanoseconds_t to = std::min ( windowEnd, this->latestEndTime );
+    if ( from >= to ) //reported nothing during the window
+        return std::nullopt;
+    return StationAvailabilityReportFactory::uptimeFraction ( this->availableUntil ( to ) - this->availableUntil ( from ), to - from );
+}
+
+StationAvailabilityReport UptimeIndex::getReport ( nanoseconds_t windowStart, nanoseconds_t windowEnd ) const {
+    checkWindow ( windowStart, windowEnd );
+    StationAvailabilityReport report;
+    for ( const auto& index : this->stations ) {
+        if ( const auto uptime = index.uptime ( windowStart, windowEnd ) )
+            report += StationAvailabilityEntry ( index.stationID, *uptime );
+    }
+    return report;
+}
+
+std::optional<float> UptimeIndex::getUptime ( ChargingNodes::stationID_t stationID, nanoseconds_t windowStart, nanoseconds_t windowEnd ) const {
+    checkWindow ( windowStart, windowEnd );
+    const auto index = std::ranges::lower_bound ( this->stations, stationID, {}, &StationIndex::stationID );
+    if ( index == this->stations.end() or index->stationID != stationID )
+        return std::nullopt;
+    return index->uptime ( windowStart, windowEnd );
+}
+
+} //namespace Availability
@@ -0,0 +1,146 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+#ifndef UPTIMEINDEX_H
+#define UPTIMEINDEX_H
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "AvailabilityEvent.h"
+#include "Station.h"
+#include "StationAvailabilityReport.h"
+
+namespace Availability {
+using std::shared_ptr;
+using std::map;
+
+/**
+ * @brief Answers uptime queries for arbitrary time windows [windowStart, windowEnd).
+ * See Spec Section 2.3 for uptime over a Station's whole reporting span.
+ *
+ * For each Station the index keeps the union of its Chargers' available time as disjoint
+ * intervals in time order, with a running total (prefix sum) of their lengths, plus the
+ * Station's earliest start and latest end time. The available time up to any instant t is then
+ * one binary search away, and the available time within a window is the difference of two
+ * such lookups: O(log n) per Station and window, however long the window.
+ *
+ * The uptime of a Station within a window is its available time within the window, divided by
+ * the part of the window within the Station's reporting span [earliest start, latest end).
+ * For the window of the whole span that's exactly the number in the Station's report line.
+ * A Station which reported nothing during the window has no uptime for it.
+ *
+ *      UptimeIndex index {stations};
+ *      StationAvailabilityReport lastDay = index.getReport ( now - 24h, now );
+ *
+ * The index is a snapshot: it doesn't see events added to the Stations after it was built.
+ */
+class UptimeIndex
+{
+public:
+    /**
+     * @brief An UptimeIndex built on first use and kept until reset, for ChargingNetwork.
+     * Safe to use from several threads. A copy starts out empty and builds its own.
+     */
+    class Cache
+    {
+    public:
+        Cache() = default;
+        Cache ( const Cache& ) {}
+        Cache& operator= ( const Cache& ) { this->reset(); return *this; }
+
+        /**
+         * @brief The index, built from stations if there isn't one yet.
+         *
+         * @param stations the Stations to index
+         * @return shared_ptr<const UptimeIndex>
+         */
+        shared_ptr<const UptimeIndex> get ( const map<ChargingNodes::stationID_t, shared_ptr<ChargingNodes::Station>>& stations );
+
+        /**
+         * @brief Drop the index, e.g. because the Stations changed.
+         */
+        void reset();
+
+    protected:
+        std::mutex mutex;
+        shared_ptr<const UptimeIndex> index;
+    };
+
+    /**
+     * Default constructor. Indexes no Stations.
+     */
+    UptimeIndex();
+
+    /**
+     * @brief Constructor. Indexes every Station.
+     *
+     * @param stations the Stations to index, keyed by station ID
+     */
+    explicit UptimeIndex ( const map<ChargingNodes::stationID_t, shared_ptr<ChargingNodes::Station>>& stations );
+
+    /**
+     * @brief Uptime of every Station within a window, in station ID order.
+     * Stations which reported nothing during the window are left out.
+     * Throws std::invalid_argument if windowStart isn't before windowEnd.
+     *
+     * @param windowStart start of the window
+     * @param windowEnd end of the window, not included
+     * @return StationAvailabilityReport
+     */
+    StationAvailabilityReport getReport ( nanoseconds_t windowStart, nanoseconds_t windowEnd ) const;
+
+    /**
+     * @brief Uptime of one Station within a window.
+     * Throws std::invalid_argument if windowStart isn't before windowEnd.
+     *
+     * @param stationID the Station
+     * @param windowStart start of the window
+     * @param windowEnd end of the window, not included
+     * @return std::optional<float> nothing if there's no such Station, or it reported nothing during the window
+     */
+    std::optional<float> getUptime ( ChargingNodes::stationID_t stationID, nanoseconds_t windowStart, nanoseconds_t windowEnd ) const;
+
+protected:
+    /**
+     * @brief The index of one Station.
+     */
+    struct StationIndex {
+        ChargingNodes::stationID_t stationID {0};
+        nanoseconds_t earliestStartTime {UINT64_MAX};
+        nanoseconds_t latestEndTime {0};
+        /**
+         * @brief The disjoint available intervals, in time order.
+         */
+        std::vector<nanoseconds_t> startTimes;
+        std::vector<nanoseconds_t> endTimes;
+        /**
+         * @brief availableBefore[i] is the total length of intervals 0 to i - 1.
+         */
+        std::vector<nanoseconds_t> availableBefore;
+
+        /**
+         * @brief Total available time before instant t.
+         */
+        nanoseconds_t availableUntil ( nanoseconds_t t ) const;
+
+        /**
+         * @brief Uptime within [windowStart, windowEnd), if the Station reported during it.
+         */
+        std::optional<float> uptime ( nanoseconds_t windowStart, nanoseconds_t windowEnd ) const;
+    };
+
+    /**
+     * @brief One StationIndex per Station, in station ID order.
+     */
+    std::vector<StationIndex> stations;
+};
+
+} //namespace Availability
+
+#endif // UPTIMEINDEX_H
@@ -0,0 +1,72 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "UptimeSeriesReport.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace Availability {
+
+std::size_t StationUptimeSeries::bucketCount ( nanoseconds_t earliestStartTime, nanoseconds_t latestEndTime, nanoseconds_t bucketWidth ) noexcept {
+    if ( earliestStartTime > latestEndTime ) //no events
+        return 0;
+    const nanoseconds_t span = latestEndTime - ( earliestStartTime - earliestStartTime % bucketWidth );
+    return std::max<nanoseconds_t> ( span / bucketWidth + ( span % bucketWidth != 0 ), 1 );
+}
+
+StationUptimeSeries StationUptimeSeries::sweep ( ChargingNodes::stationID_t stationID, std::span<const IntervalSort::Interval> merged,
+                                                 nanoseconds_t earliestStartTime, nanoseconds_t latestEndTime, nanoseconds_t bucketWidth ) {
+    StationUptimeSeries series;
+    series.stationID = stationID;
+    if ( earliestStartTime > latestEndTime ) //no events
+        return series;
+
+    series.firstBucketStart = earliestStartTime - earliestStartTime % bucketWidth;
+    const std::size_t buckets = bucketCount ( earliestStartTime, latestEndTime, bucketWidth );
+    series.availableTime.assign ( buckets, 0 );
+    series.reportingTime.assign ( buckets, 0 );
+
+    //Spread [startTime, endTime) over the buckets it crosses, adding to column. Offsets from
+    //firstBucketStart rather than absolute bucket ends, so nothing overflows near UINT64_MAX.
+    auto spread = [&series, bucketWidth] ( vector<nanoseconds_t>& column, nanoseconds_t startTime, nanoseconds_t endTime ) {
+        nanoseconds_t offset = startTime - series.firstBucketStart;
+        nanoseconds_t remaining = endTime - startTime;
+        while ( remaining > 0 ) {
+            const nanoseconds_t inBucket = std::min ( remaining, bucketWidth - offset % bucketWidth );
+            column[offset / bucketWidth] += inBucket;
+            offset += inBucket;
+            remaining -= inBucket;
+        }
+    };
+
+    spread ( series.reportingTime, earliestStartTime, latestEndTime );
+    //One pass over the intervals. They're disjoint and in time order, so every bucket is touched
+    //by at most the intervals within it plus one: O(intervals + buckets) in all.
+    for ( const auto& interval : merged ) {
+        spread ( series.availableTime, interval.startTime, interval.endTime );
+    }
+    return series;
+}
+
+UptimeSeriesReport::UptimeSeriesReport() = default;
+
+UptimeSeriesReport::UptimeSeriesReport ( nanoseconds_t bucketWidth ) : bucketWidth {bucketWidth} {
+}
+
+UptimeSeriesReport& UptimeSeriesReport::operator+= ( StationUptimeSeries series ) {
+    this->series.push_back ( std::move ( series ) );
+    return *this;
+}
+
+std::ostream& operator<< ( std::ostream& os, const UptimeSeriesReport& report ) {
+    for ( const auto& series : report.getSeries() ) {
+        for ( std::size_t i = 0; i < series.availableTime.size(); ++i ) {
+            os << series.stationID << " " << series.firstBucketStart + i * report.getBucketWidth()
+               << " " << series.availableTime[i] << " " << series.reportingTime[i] << "\n";
+        }
+    }
+    return os;
+}
+
+} //namespace Availability
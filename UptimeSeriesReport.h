@@ -0,0 +1,133 @@
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+#ifndef UPTIMESERIESREPORT_H
+#define UPTIMESERIESREPORT_H
+
+#include "AvailabilityEvent.h"
+#include "IntervalSort.h"
+#include "Station.h"
+
+#include <cstddef>
+#include <ostream>
+#include <span>
+#include <vector>
+
+namespace Availability {
+
+/**
+ * @brief Uptime of one Station, bucket by bucket.
+ * Bucket i covers [firstBucketStart + i * bucketWidth, firstBucketStart + (i + 1) * bucketWidth).
+ * Buckets are aligned to multiples of the bucket width, so with timestamps since the epoch an
+ * hour-wide bucket is a clock hour.
+ * The series is dense: every bucket from the Station's earliest start time to its latest end
+ * time is there, even those with nothing available.
+ */
+struct StationUptimeSeries {
+    ChargingNodes::stationID_t stationID {0};
+    nanoseconds_t firstBucketStart {0};
+    /**
+     * @brief Time any Charger at the Station was available, per bucket.
+     */
+    vector<nanoseconds_t> availableTime;
+    /**
+     * @brief Part of each bucket within the Station's reporting span, from its earliest start time
+     * to its latest end time. availableTime / reportingTime is the uptime in the bucket.
+     */
+    vector<nanoseconds_t> reportingTime;
+
+    bool operator== ( const StationUptimeSeries& other ) const = default;
+
+    /**
+     * @brief Number of buckets sweep() makes for a Station's reporting span.
+     *
+     * @param earliestStartTime start of the Station's reporting span. UINT64_MAX if it has no events.
+     * @param latestEndTime end of the Station's reporting span
+     * @param bucketWidth width of a bucket, greater than 0
+     * @return std::size_t 0 if the Station has no events, else at least 1
+     */
+    static std::size_t bucketCount ( nanoseconds_t earliestStartTime, nanoseconds_t latestEndTime, nanoseconds_t bucketWidth ) noexcept;
+
+    /**
+     * @brief Build a series in one sweep over a Station's available time.
+     * O(intervals + buckets).
+     *
+     * @param stationID the Station
+     * @param merged the Station's available time, as disjoint intervals in time order
+     * @param earliestStartTime start of the Station's reporting span. UINT64_MAX if it has no events.
+     * @param latestEndTime end of the Station's reporting span
+     * @param bucketWidth width of a bucket, greater than 0
+     * @return StationUptimeSeries empty if the Station has no events
+     */
+    static StationUptimeSeries sweep ( ChargingNodes::stationID_t stationID, std::span<const IntervalSort::Interval> merged,
+                                       nanoseconds_t earliestStartTime, nanoseconds_t latestEndTime, nanoseconds_t bucketWidth );
+};
+
+/**
+ * @brief Encapsulates a bucketed uptime report: a StationUptimeSeries per Station.
+ * The bucketed counterpart of StationAvailabilityReport, for dashboards which want uptime per
+ * hour or per day rather than over a Station's whole reporting span.
+ *
+ *      ChargingNetwork cn {chargingNetworkDataFile};
+ *      UptimeSeriesReport hourly = cn.getUptimeSeriesReport ( 3600'000'000'000 );
+ *      cout << hourly;
+ *
+ * Summing a Station's buckets gives back its StationAvailabilityReport numerator and denominator.
+ */
+class UptimeSeriesReport
+{
+public:
+    /**
+     * @brief Most buckets a report holds, summed over its Stations. Every bucket is two counters
+     * and a line of output, so a bucket width far below the span of the data would otherwise
+     * exhaust memory before anything is written.
+     */
+    static constexpr std::size_t MAX_BUCKETS {1u << 24};
+
+    /**
+     * Default constructor. Bucket width 1.
+     */
+    UptimeSeriesReport();
+
+    /**
+     * @brief Constructor.
+     *
+     * @param bucketWidth width of every bucket of every series
+     */
+    explicit UptimeSeriesReport ( nanoseconds_t bucketWidth );
+
+    /**
+     * @brief Add a Station's series. Series are kept in the order added.
+     *
+     * @param series the series to add
+     * @return UptimeSeriesReport&
+     */
+    UptimeSeriesReport& operator+= ( StationUptimeSeries series );
+
+    bool operator== ( const UptimeSeriesReport& other ) const = default;
+
+    nanoseconds_t getBucketWidth() const noexcept { return this->bucketWidth; }
+    const vector<StationUptimeSeries>& getSeries() const noexcept { return this->series; }
+
+protected:
+    nanoseconds_t bucketWidth {1};
+    vector<StationUptimeSeries> series;
+};
+
+/**
+ * @brief Write to output stream.
+ * One line per bucket: station ID, bucket start, available time, reporting time, each line
+ * ending in a newline.
+ *
+ *      0 3600 1800 3600
+ *
+ * @param os Output stream to write to.
+ * @param report UptimeSeriesReport to write
+ * @return std::ostream&
+ */
+std::ostream& operator<< ( std::ostream& os, const UptimeSeriesReport& report );
+
+} //namespace Availability
+
+#endif // UPTIMESERIESREPORT_H
@@ -0,0 +1,295 @@
+// Time each stage of producing a station availability report, over data files from kilobytes to gigabytes.
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+using std::string;
+#include <vector>
+using std::vector;
+
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+
+#include "Benchmarking.h"
+#include "ChargingNetwork.h"
+#include "OptionParsing.h"
+#include "ParallelFor.h"
+#include "StationAvailabilityReport.h"
+#include "StationAvailabilityReportFactory.h"
+#include "SyntheticNetworkGenerator.h"
+
+using namespace Charging;
+
+namespace {
+
+/**
+ * @brief The timing of one stage over one data file.
+ */
+struct Result {
+    string input;           ///< the data file, or its generated size
+    string stage;
+    unsigned runs {0};
+    double seconds {0};     ///< of the fastest run
+    std::size_t items {0};  ///< events, or Stations for the stages which work on report entries
+    std::size_t bytes {0};  ///< bytes read or written per run, 0 if that doesn't apply
+};
+
+//Each stage runs at least MIN_RUNS times, and then again until MIN_SECONDS have gone by, so that
+//the small files are timed over enough runs to be steady. The fastest run is reported.
+constexpr unsigned MIN_RUNS {3};
+constexpr unsigned MAX_RUNS {1000};
+constexpr double MIN_SECONDS {0.25};
+
+/**
+ * @brief Time work(), calling prepare() untimed before each run.
+ *
+ * @return std::pair<unsigned, double> number of runs, and seconds taken by the fastest
+ */
+std::pair<unsigned, double> time ( const std::function<void()>& prepare, const std::function<void()>& work ) {
+    double fastest {0}, total {0};
+    unsigned runs {0};
+    while ( runs < MIN_RUNS or ( total < MIN_SECONDS and runs < MAX_RUNS ) ) {
+        prepare();
+        const double seconds = timeOnce ( work );
+        fastest = ( runs == 0 ) ? seconds : std::min ( fastest, seconds );
+        total += seconds;
+        ++runs;
+    }
+    return {runs, fastest};
+}
+
+/**
+ * @brief Generate a data file of about targetBytes: Stations of one to seven Chargers, four on
+ * average, with 100 reports per Charger.
+ */
+void generate ( const std::filesystem::path& path, std::size_t targetBytes, uint64_t seed ) {
+    //an availability report line is about 50 bytes
+    static constexpr std::size_t BYTES_PER_EVENT {50};
+    SyntheticNetworkGenerator::Options options;
+    options.seed = seed;
+    options.distribution = SyntheticNetworkGenerator::ChargerDistribution::UNIFORM;
+    const std::size_t eventsPerStation = std::size_t {options.chargersPerStation} * options.eventsPerCharger;
+    options.stationCount = static_cast<uint32_t> ( std::max<std::size_t> ( 1, targetBytes / BYTES_PER_EVENT / eventsPerStation ) );
+    std::ofstream ofs {path, std::ios::binary};
+    SyntheticNetworkGenerator {options}.write ( ofs );
+}
+
+/**
+ * @brief Time every stage over one data file.
+ */
+vector<Result> benchmark ( const string& input, const std::filesystem::path& path, unsigned threadCount ) {
+    vector<Result> results;
+    const std::size_t fileBytes = std::filesystem::file_size ( path );
+    const ChargingNetwork network {path};
+    std::size_t eventCount {0};
+    for ( const auto& [chargerID, charger] : network.getChargers() )
+        eventCount += charger->getAvailabilityEvents().size();
+    const std::size_t stationCount = network.getStations().size();
+
+    auto run = [&] ( const string& stage, std::size_t items, std::size_t bytes,
+                     const std::function<void()>& prepare, const std::function<void()>& work ) {
+        const auto [runs, seconds] = time ( prepare, work );
+        results.push_back ( {input, stage, runs, seconds, items, bytes} );
+    };
+    auto nothing = [] () {};
+
+    //ChargingNetwork constructor: the parse loop, one engine at a time
+    for ( const auto& [stage, engine] : {std::pair {"parse stream", ChargingNetwork::IngestionEngine::STREAM},
+                                         {"parse mapped", ChargingNetwork::IngestionEngine::MAPPED},
+                                         {"parse parallel", ChargingNetwork::IngestionEngine::PARALLEL}} ) {
+        if ( engine == ChargingNetwork::IngestionEngine::PARALLEL and threadCount <= 1 )
+            continue;
+        run ( stage, eventCount, fileBytes, nothing, [&] () {
+            const ChargingNetwork cn {path, engine, threadCount};
+            sink = sink + cn.getStations().size();
+        } );
+    }
+
+    //StationAvailabilityReportFactory::getReport(), on each engine
+    for ( const auto& [stage, engine] : {std::pair {"report kway", StationAvailabilityReportFactory::UptimeEngine::KWAY_MERGE},
+                                         {"report consolidate", StationAvailabilityReportFactory::UptimeEngine::CONSOLIDATE_SORT}} ) {
+        run ( stage, eventCount, fileBytes, nothing, [&] () {
+            StationAvailabilityReportFactory factory {network.getStations(), 1, engine};
+            sink = sink + factory.getReport().getEntries().size();
+        } );
+    }
+
+    //The stages of the consolidate engine on their own. Collecting each Station's available
+    //events isn't timed; neither is copying them for each run, since they're sorted in place.
+    vector<vector<AvailabilityEvent>> consolidated, working, noOverlaps;
+    vector<nanoseconds_t> denominators;
+    for ( const auto& [stationID, station] : network.getStations() ) {
+        auto& events = consolidated.emplace_back();
+        nanoseconds_t earliestStartTime {UINT64_MAX}, latestEndTime {0};
+        for ( const auto& charger : station->getChargers() ) {
+            for ( const AvailabilityEvent ae : charger->getAvailabilityEvents() ) {
+                earliestStartTime = std::min ( earliestStartTime, ae.startTime );
+                latestEndTime = std::max ( latestEndTime, ae.endTime );
+                if ( ae.available )
+                    events.push_back ( ae );
+            }
+        }
+        denominators.push_back ( latestEndTime - earliestStartTime );
+    }
+    run ( "removeOverlaps", eventCount, fileBytes, [&] () { working = consolidated; }, [&] () {
+        noOverlaps.clear();
+        for ( auto& events : working )
+            noOverlaps.push_back ( StationAvailabilityReportFactory::removeOverlaps ( events, IntervalSort::Algorithm::COMPARISON ) );
+    } );
+    run ( "calculateUptime", eventCount, fileBytes, nothing, [&] () {
+        float total {0};
+        for ( std::size_t i = 0; i < noOverlaps.size(); ++i )
+            total += StationAvailabilityReportFactory::calculateUptime ( noOverlaps[i], denominators[i] );
+        sink = sink + static_cast<std::size_t> ( total );
+    } );
+
+    //StationAvailabilityReport::sort(), of entries in no particular order
+    const StationAvailabilityReport report = network.getStationAvailabilityReport();
+    StationAvailabilityReport shuffled, sorting;
+    {
+        vector<StationAvailabilityEntry> entries = report.getEntries();
+        SplitMix64 random {stationCount};
+        for ( std::size_t i = entries.size(); i > 1; --i )
+            std::swap ( entries[i - 1], entries[random.next() % i] );
+        for ( const auto& entry : entries )
+            shuffled += entry;
+    }
+    run ( "report sort", stationCount, 0, [&] () { sorting = shuffled; }, [&] () {
+        sorting.sort();
+    } );
+
+    //Writing the report. The output goes to a string, which is rewound before each run.
+    std::ostringstream output;
+    std::size_t outputBytes {0};
+    run ( "report output", stationCount, 0, [&] () { output.str ( "" ); }, [&] () {
+        output << report;
+        outputBytes = output.tellp();
+    } );
+    results.back().bytes = outputBytes;
+    return results;
+}
+
+/**
+ * @brief Print the results as a table, or as CSV for tracking over time.
+ */
+void print ( const vector<Result>& results, bool csv ) {
+    if ( csv ) {
+        std::cout << "input,stage,runs,seconds,items,items_per_second,ns_per_item,bytes_per_second\n";
+    } else {
+        std::printf ( "%-14s %-20s %6s %12s %12s %14s %10s %10s\n",
+                      "input", "stage", "runs", "best ms", "items", "items/s", "ns/item", "MB/s" );
+    }
+    for ( const auto& r : results ) {
+        const double itemsPerSecond = r.items / r.seconds;
+        const double nsPerItem = r.seconds * 1e9 / std::max<std::size_t> ( r.items, 1 );
+        const double bytesPerSecond = r.bytes / r.seconds;
+        if ( csv ) {
+            std::cout << r.input << "," << r.stage << "," << r.runs << "," << r.seconds << "," << r.items << ","
+                      << itemsPerSecond << "," << nsPerItem << "," << ( r.bytes ? bytesPerSecond : 0 ) << "\n";
+        } else if ( r.bytes ) {
+            std::printf ( "%-14s %-20s %6u %12.3f %12zu %14.0f %10.1f %10.1f\n", r.input.c_str(), r.stage.c_str(),
+                          r.runs, r.seconds * 1e3, r.items, itemsPerSecond, nsPerItem, bytesPerSecond / 1e6 );
+        } else {
+            std::printf ( "%-14s %-20s %6u %12.3f %12zu %14.0f %10.1f %10s\n", r.input.c_str(), r.stage.c_str(),
+                          r.runs, r.seconds * 1e3, r.items, itemsPerSecond, nsPerItem, "-" );
+        }
+    }
+    std::cout.flush();
+}
+
+} //namespace
+
+/**
+ * @brief Entry point for electra2_bench.
+ * Times, for each data file:
+ * - the ChargingNetwork constructor, on each IngestionEngine;
+ * - StationAvailabilityReportFactory::getReport(), on each UptimeEngine;
+ * - the removeOverlaps() and calculateUptime() stages of CONSOLIDATE_SORT on their own;
+ * - StationAvailabilityReport::sort() and writing the report.
+ * and prints the fastest of several runs, with throughput and cost per item. Items are events,
+ * or Stations for sorting and writing the report. Build with CMAKE_BUILD_TYPE=Release.
+ *
+ * Options:
+ *
+ *      --sizes LIST    Generate data files of these sizes, e.g. 16K,1M,64M,1G (the default is
+ *                      16K,1M,64M), and time each of them. See SyntheticNetworkGenerator.
+ *      --seed N        Seed for the generated data files.
+ *      --threads N     Threads for the parallel parse. 0 (the default) means one per core.
+ *      --csv           Print CSV instead of a table.
+ *
+ * Data files given after the options are timed instead of generated ones.
+ *
+ * @param argc The number of arguments passed on the command line
+ * @param argv The arguments
+ * @return int
+ */
+int main(int argc, char **argv) {
+
+    auto usageError = [argv] (const string& explanation) {
+        std::cerr << explanation << "\n";
+        std::cerr << "Usage: " << argv[0] << " [--sizes 16K,1M,64M,1G] [--seed N] [--threads N] [--csv] [data files...]\n";
+        return EXIT_FAILURE;
+    };
+
+    vector<std::size_t> sizes {16'000, 1'000'000, 64'000'000};
+    uint64_t seed {1};
+    unsigned threadCount {0};
+    bool csv {false};
+    int arg = 1;
+    for ( ; arg < argc and string(argv[arg]).starts_with("--"); ++arg) {
+        const string option {argv[arg]};
+        try {
+            if (option == "--sizes" and arg + 1 < argc) {
+                sizes.clear();
+                std::istringstream list {argv[++arg]};
+                for (string size; std::getline(list, size, ',');)
+                    sizes.push_back(SyntheticNetworkGenerator::parseCount(size));
+            } else if (option == "--seed" and arg + 1 < argc) {
+                seed = parseUnsigned(argv[++arg]);
+            } else if (option == "--threads" and arg + 1 < argc) {
+                threadCount = parseUnsigned(argv[++arg], UINT_MAX);
+            } else if (option == "--csv") {
+                csv = true;
+            } else {
+                return usageError("Unknown option: " + option);
+            }
+        } catch (const std::logic_error&) {
+            return usageError("Invalid value for " + option + ": " + argv[arg]);
+        }
+    }
+    threadCount = resolveThreadCount(threadCount);
+
+    vector<Result> results;
+    try {
+        if (arg < argc) {
+            for ( ; arg < argc; ++arg) {
+                auto fileResults = benchmark(std::filesystem::path(argv[arg]).filename().string(), argv[arg], threadCount);
+                results.insert(results.end(), fileResults.begin(), fileResults.end());
+            }
+        } else {
+            for (const std::size_t size : sizes) {
+                const auto path = std::filesystem::temp_directory_path() / ("electra2_bench_" + std::to_string(size) + ".txt");
+                vector<Result> fileResults;
+                try {
+                    generate(path, size, seed);
+                    fileResults = benchmark(std::to_string(std::filesystem::file_size(path)) + "B", path, threadCount);
+                } catch (...) { //a generated file of a gigabyte shouldn't be left behind
+                    std::filesystem::remove(path);
+                    throw;
+                }
+                std::filesystem::remove(path);
+                results.insert(results.end(), fileResults.begin(), fileResults.end());
+            }
+        }
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << "\n";
+        return EXIT_FAILURE;
+    }
+    print(results, csv);
+    return EXIT_SUCCESS;
+}
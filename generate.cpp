@@ -0,0 +1,123 @@
+// Write a synthetic input data file, of any size, for benchmarks and scaling tests.
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include <iostream>
+#include <fstream>
+#include <string>
+using std::string;
+
+#include <cstdint>
+
+#include "OptionParsing.h"
+#include "SyntheticNetworkGenerator.h"
+
+using namespace Charging;
+
+/**
+ * @brief Entry point for electra2_generate.
+ * Writes a data file to stdout, or to the file given with --output. See SyntheticNetworkGenerator.
+ *
+ * Options:
+ *
+ *      --seed N            Seed of the random numbers. The same options and seed give the same file.
+ *      --stations N        Number of stations.
+ *      --chargers N        Chargers per station; the mean for uniform and skewed.
+ *      --distribution D    fixed, uniform or skewed. How chargers are spread over stations.
+ *      --events N          Availability reports per charger.
+ *      --overlap P         Chance, 0 to 1, that a report overlaps the charger's previous one.
+ *      --duplicates P      Chance that a report is written twice.
+ *      --sortedness P      1 writes the reports in time order; less holds some back.
+ *      --uptime P          Chance that a report says the charger was available.
+ *      --whitespace W      spaces, tabs or mixed.
+ *      --output FILE       Write to FILE instead of stdout.
+ *
+ * @param argc The number of arguments passed on the command line
+ * @param argv The arguments
+ * @return int
+ */
+int main(int argc, char **argv) {
+
+    auto usageError = [argv] (const string& explanation) {
+        std::cerr << explanation << "\n";
+        std::cerr << "Usage: " << argv[0] << " [--seed N] [--stations N] [--chargers N] [--distribution fixed|uniform|skewed] [--events N]"
+                     " [--overlap P] [--duplicates P] [--sortedness P] [--uptime P] [--whitespace spaces|tabs|mixed] [--output FILE]\n";
+        return EXIT_FAILURE;
+    };
+
+    SyntheticNetworkGenerator::Options options;
+    string outputFile;
+    for (int arg = 1; arg < argc; ++arg) {
+        const string option {argv[arg]};
+        if (arg + 1 >= argc) {
+            return usageError("Missing value for " + option);
+        }
+        const string value {argv[++arg]};
+        try {
+            auto probability = [&value] () {
+                const double p = std::stod(value);
+                if (p < 0.0 or p > 1.0)
+                    throw std::out_of_range(value);
+                return p;
+            };
+            if (option == "--seed") {
+                options.seed = parseUnsigned(value);
+            } else if (option == "--stations") {
+                options.stationCount = parseUnsigned(value, UINT32_MAX);
+            } else if (option == "--chargers") {
+                options.chargersPerStation = parseUnsigned(value, UINT32_MAX);
+                if (options.chargersPerStation == 0)
+                    throw std::out_of_range(value);
+            } else if (option == "--distribution") {
+                if (value == "fixed")
+                    options.distribution = SyntheticNetworkGenerator::ChargerDistribution::FIXED;
+                else if (value == "uniform")
+                    options.distribution = SyntheticNetworkGenerator::ChargerDistribution::UNIFORM;
+                else if (value == "skewed")
+                    options.distribution = SyntheticNetworkGenerator::ChargerDistribution::SKEWED;
+                else
+                    throw std::invalid_argument(value);
+            } else if (option == "--events") {
+                options.eventsPerCharger = parseUnsigned(value, UINT32_MAX);
+            } else if (option == "--overlap") {
+                options.overlapRate = probability();
+            } else if (option == "--duplicates") {
+                options.duplicateRate = probability();
+            } else if (option == "--sortedness") {
+                options.sortedness = probability();
+            } else if (option == "--uptime") {
+                options.uptime = probability();
+            } else if (option == "--whitespace") {
+                if (value == "spaces")
+                    options.whitespace = SyntheticNetworkGenerator::Whitespace::SPACES;
+                else if (value == "tabs")
+                    options.whitespace = SyntheticNetworkGenerator::Whitespace::TABS;
+                else if (value == "mixed")
+                    options.whitespace = SyntheticNetworkGenerator::Whitespace::MIXED;
+                else
+                    throw std::invalid_argument(value);
+            } else if (option == "--output") {
+                outputFile = value;
+            } else {
+                return usageError("Unknown option: " + option);
+            }
+        } catch (const std::logic_error&) { //std::invalid_argument and std::out_of_range
+            return usageError("Invalid value for " + option + ": " + value);
+        }
+    }
+
+    const SyntheticNetworkGenerator generator {options};
+    if (outputFile.empty()) {
+        std::ios::sync_with_stdio(false);
+        generator.write(std::cout);
+        std::cout.flush();
+        return std::cout ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    std::ofstream ofs {outputFile, std::ios::binary};
+    if (!ofs) {
+        std::cerr << "Could not open " << outputFile << "\n";
+        return EXIT_FAILURE;
+    }
+    generator.write(ofs);
+    ofs.close();
+    return ofs ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -7,14 +7,109 @@ using std::cout;
 #include <string>
 using std::string;
 
+#include <algorithm>
 #include <filesystem>
+#include <chrono>
+#include <climits>
+#include <csignal>
+#include <cstdint>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <system_error>
+#include <streambuf>
+#include <thread>
+#include <utility>
 
 #include "Charging.h"
 #include "ChargingNetwork.h"
 #include "StationAvailabilityReport.h"
+#include "StreamingUptimeEngine.h"
+#include "NetworkSnapshot.h"
+#include "DataFileFollower.h"
+#include "ReportClient.h"
+#include "ReportServer.h"
+#include "RunStats.h"
+#include "AllocationTracker.h"
+#include "ReportWriter.h"
+#include "ParallelFor.h"
+#include "OptionParsing.h"
 
 using namespace Charging;
 
+namespace {
+
+/**
+ * @brief Passes everything written to it on to another stream buffer, counting the bytes and
+ * lines, for the output phase of --stats.
+ */
+class CountingBuffer : public std::streambuf
+{
+public:
+    explicit CountingBuffer(std::streambuf* target) : target {target} {}
+
+    uint64_t bytes {0};
+    uint64_t lines {0};
+
+protected:
+    int_type overflow(int_type c) override {
+        if (traits_type::eq_int_type(c, traits_type::eof())) {
+            return traits_type::not_eof(c);
+        }
+        ++this->bytes;
+        this->lines += (traits_type::to_char_type(c) == '\n');
+        return this->target->sputc(traits_type::to_char_type(c));
+    }
+
+    std::streamsize xsputn(const char* s, std::streamsize n) override {
+        this->bytes += n;
+        this->lines += std::count(s, s + n, '\n');
+        return this->target->sputn(s, n);
+    }
+
+    int sync() override { return this->target->pubsync(); }
+
+private:
+    std::streambuf* target;
+};
+
+/**
+ * @brief Write a report to stdout, in the format asked for.
+ */
+void print(const StationAvailabilityReport& report, ReportWriter::Format format) {
+    ReportWriter(cout, format).write(report);
+}
+
+/**
+ * @brief Write a bucketed report to stdout. It only comes as text.
+ */
+void print(const UptimeSeriesReport& report, ReportWriter::Format) {
+    cout << report;
+}
+
+} //namespace
+
+/**
+ * @brief The server --serve runs, for the signal handlers.
+ */
+static ReportServer* runningServer {nullptr};
+
+/**
+ * @brief SIGINT and SIGTERM stop the server, SIGHUP has it reload the data file.
+ *
+ * @param signal the signal
+ */
+extern "C" void handleServerSignal(int signal) {
+    if (runningServer == nullptr) {
+        return;
+    }
+    if (signal == SIGHUP) {
+        runningServer->requestReload();
+    } else {
+        runningServer->stop();
+    }
+}
+
 /**
  * @brief Starts the program.
  *
@@ -24,40 +119,360 @@ using namespace Charging;
  * stdout.
  *
  *
+ * Options:
+ *
+ *      --threads N     Parse the availability reports, and compute the stations' uptime, on N
+ *                      threads, N at least 1. A count far past the cores is clamped; see
+ *                      resolveThreadCount().
+ *      --streaming     Compute the report in a single pass over the file, keeping only the
+ *                      topology and a running total per station. See StreamingUptimeEngine.
+ *      --coalesce      Merge back-to-back availability reports of a charger with the same
+ *                      availability, and drop retransmitted duplicates, as they're read. The
+ *                      report is the same; less memory is used. See ChargingNetwork::EventCoalescing.
+ *      --save-snapshot FILE
+ *                      After reading the data file, also save it as a binary snapshot.
+ *      --snapshot      The data file is a snapshot written by --save-snapshot. Only its structure is
+ *                      checked, so loading it costs about as much as opening it. See NetworkSnapshot.
+ *      --verify-snapshot
+ *                      --snapshot, and verify its checksum too, which reads the whole file.
+ *      --window T0 T1  Report uptime within [T0, T1) only, in the data file's time units.
+ *                      Stations which reported nothing in the window are left out.
+ *      --buckets W     Report available and reporting time per station per bucket of width W
+ *                      instead, one line per bucket. At most UptimeSeriesReport::MAX_BUCKETS
+ *                      buckets in all, or it's an error. See UptimeSeriesReport.
+ *      --follow MS     Keep following the data file as lines are appended to it, checking every MS
+ *                      milliseconds (at most a day), and print the report again, followed by a blank line,
+ *                      whenever new availability reports came in. Runs until killed.
+ *                      See DataFileFollower.
+ *      --serve SOCKET  Read the data file once, then answer queries on the Unix domain socket
+ *                      SOCKET until SIGINT or SIGTERM. SIGHUP reloads the data file.
+ *                      See ReportServer.
+ *      --query SOCKET  Instead of reading a data file, ask the server on SOCKET. The argument
+ *                      after the options is the query: report, station ID, charger ID or reload.
+ *      --format F      Write the report as text (the Spec report, the default), csv, jsonl or
+ *                      binary. See ReportWriter.
+ *      --stats         When done, write the wall time, lines, events and bytes processed, and
+ *                      peak memory, of each phase of the run to stderr, as one line of JSON.
+ *                      stdout is the same as without it. See RunStats.
+ *      --alloc-stats   --stats, and the heap allocations of each phase too: how many, their bytes
+ *                      and the peak of live bytes. Allocating is slower while they're counted.
+ *                      See AllocationTracker.
+ *
+ * Environment:
+ *
+ *      ELECTRA2_TRACE=FILE  Trace to FILE, or to stderr if FILE is "-". Only in builds with
+ *                      tracing compiled in, which Debug builds are by default. See Tracer.
+ *
  * @param argc The number of arguments passed on the command line. intut
  * @param argv The arguments. A pointer to char pointers
  * @return int
  */
 int main(int argc, char **argv) {
 
-    Debug( "Electric Era Charging Network Uptime Report Display Program" << std::endl );
-#ifdef _DEBUG
-    Debug( "_DEBUG\n" );
-#endif
-#ifdef NDEBUG
-    //cout << "NDEBUG\n";
-#endif
-
-    if (1 == argc ) { //if no arguments specified, only name of currently running program
+    auto usageError = [argv] (const string& explanation) {
         std::cout << ChargingNetwork::ERROR_TEXT << "\n"; //Note: std::endl is not required bc we don't need to flush the stream
-        std::cerr << "No data file specified\n"; // Output detailed error to stderr, not stdout. See Spec Section 2.3.2
-        std::cerr << "Usage: " << argv[0] << " path_to_data_file\n";
+        std::cerr << explanation << "\n"; // Output detailed error to stderr, not stdout. See Spec Section 2.3.2
+        std::cerr << "Usage: " << argv[0] << " [--threads N | --streaming] [--coalesce] [--save-snapshot FILE] [--snapshot | --verify-snapshot] [--window T0 T1 | --buckets W] [--follow MS] [--serve SOCKET] [--format F] [--stats | --alloc-stats] path_to_data_file\n";
+        std::cerr << "       " << argv[0] << " [--format F] --query SOCKET report | station ID | charger ID | reload\n";
+        std::cerr << "  --threads N   parse and compute the report on N threads (N >= 1)\n";
+        std::cerr << "  --streaming   compute the report in one pass, without loading the events\n";
+        std::cerr << "  --coalesce    merge back-to-back and duplicate availability reports as they're read\n";
+        std::cerr << "  --save-snapshot FILE  also save the parsed data file as a binary snapshot\n";
+        std::cerr << "  --snapshot    the data file is a binary snapshot\n";
+        std::cerr << "  --verify-snapshot  the data file is a binary snapshot; verify its checksum\n";
+        std::cerr << "  --window T0 T1  report uptime within [T0, T1) only\n";
+        std::cerr << "  --buckets W   report available and reporting time per bucket of width W\n";
+        std::cerr << "  --follow MS   follow the data file as it grows, reporting again every MS milliseconds it changed\n";
+        std::cerr << "  --serve SOCKET  answer queries on the Unix domain socket SOCKET\n";
+        std::cerr << "  --query SOCKET  ask the server on SOCKET instead of reading a data file\n";
+        std::cerr << "  --format F    write the report as text, csv, jsonl or binary\n";
+        std::cerr << "  --stats       write the time, work and memory of each phase to stderr, as JSON\n";
+        std::cerr << "  --alloc-stats --stats, counting the heap allocations of each phase too\n";
         return EXIT_FAILURE;
+    };
+
+    //the command line was fine, running it wasn't
+    auto runError = [] (const string& explanation) {
+        std::cout << ChargingNetwork::ERROR_TEXT << "\n";
+        std::cerr << explanation << "\n";
+        return EXIT_FAILURE;
+    };
+
+#if ELECTRA2_TRACE_LEVEL > 0
+    //ELECTRA2_TRACE=FILE traces to FILE, or to stderr if it's "-". See Tracer.
+    std::optional<Tracer::Session> traceSession;
+    if (const char* traceFile = std::getenv("ELECTRA2_TRACE")) {
+        try {
+            traceSession.emplace(std::filesystem::path {traceFile});
+        } catch (std::filesystem::filesystem_error&) {
+            return usageError("Could not open trace file: " + string(traceFile));
+        }
+    }
+#endif
+
+    //Options come before the data file. Anything else starting with "--" is an error.
+    auto engine = ChargingNetwork::IngestionEngine::MAPPED;
+    unsigned threadCount = 1;
+    bool streaming = false;
+    bool fromSnapshot = false;
+    auto snapshotVerification = NetworkSnapshot::Verification::STRUCTURE;
+    auto coalescing = ChargingNetwork::EventCoalescing::NONE;
+    std::filesystem::path saveSnapshotFile;
+    std::optional<std::pair<nanoseconds_t, nanoseconds_t>> window;
+    nanoseconds_t bucketWidth = 0;
+    std::optional<std::chrono::milliseconds> followInterval;
+    std::filesystem::path serveSocket;
+    std::filesystem::path querySocket;
+    std::optional<RunStats> runStats;
+    std::optional<AllocationTracker> allocationTracker;
+    auto reportFormat = ReportWriter::Format::TEXT;
+    int arg = 1;
+    for ( ; arg < argc and string(argv[arg]).starts_with("--"); ++arg) {
+        const string option {argv[arg]};
+        if (option == "--threads" and arg + 1 < argc) {
+            try {
+                threadCount = parseUnsigned(argv[++arg], UINT_MAX);
+            } catch (std::exception&) {
+                return usageError("Invalid thread count: " + string(argv[arg]));
+            }
+            if (threadCount == 0) {
+                return usageError("Invalid thread count: " + string(argv[arg]) + ", it must be at least 1");
+            }
+            threadCount = resolveThreadCount(threadCount); //clamped
+            engine = ChargingNetwork::IngestionEngine::PARALLEL;
+        } else if (option == "--streaming") {
+            streaming = true;
+        } else if (option == "--coalesce") {
+            coalescing = ChargingNetwork::EventCoalescing::MERGE;
+        } else if (option == "--save-snapshot" and arg + 1 < argc) {
+            saveSnapshotFile = argv[++arg];
+        } else if (option == "--snapshot") {
+            fromSnapshot = true;
+        } else if (option == "--verify-snapshot") {
+            fromSnapshot = true;
+            snapshotVerification = NetworkSnapshot::Verification::FULL;
+        } else if (option == "--window" and arg + 2 < argc) {
+            const string start {argv[arg + 1]}, end {argv[arg + 2]};
+            try {
+                window = {parseUnsigned(start), parseUnsigned(end)};
+            } catch (std::exception&) {
+                return usageError("Invalid window: " + start + " " + end);
+            }
+            if (window->first >= window->second) {
+                return usageError("Empty window: " + start + " " + end + ", T0 must be before T1");
+            }
+            arg += 2;
+        } else if (option == "--buckets" and arg + 1 < argc) {
+            try {
+                bucketWidth = parseUnsigned(argv[++arg]);
+            } catch (std::exception&) {
+                return usageError("Invalid bucket width: " + string(argv[arg]));
+            }
+            if (bucketWidth == 0) {
+                return usageError("Invalid bucket width: " + string(argv[arg]));
+            }
+        } else if (option == "--follow" and arg + 1 < argc) {
+            try {
+                //at most a day: stoul took "-1" as 2^64 - 1 milliseconds
+                const auto day = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::hours {24});
+                followInterval = std::chrono::milliseconds {parseUnsigned(argv[++arg], day.count())};
+            } catch (std::exception&) {
+                return usageError("Invalid follow interval: " + string(argv[arg]));
+            }
+        } else if (option == "--serve" and arg + 1 < argc) {
+            serveSocket = argv[++arg];
+        } else if (option == "--query" and arg + 1 < argc) {
+            querySocket = argv[++arg];
+        } else if (option == "--format" and arg + 1 < argc) {
+            const auto format = ReportWriter::parseFormat(argv[++arg]);
+            if (!format) {
+                return usageError("Invalid format: " + string(argv[arg]));
+            }
+            reportFormat = *format;
+        } else if (option == "--stats") {
+            runStats.emplace();
+        } else if (option == "--alloc-stats") {
+            runStats.emplace();
+            allocationTracker.emplace();
+        } else {
+            return usageError("Unknown option: " + option);
+        }
+    }
+
+    if (streaming and (fromSnapshot or !saveSnapshotFile.empty())) {
+        return usageError("--streaming doesn't read or write snapshots");
+    }
+    if (streaming and (window or bucketWidth > 0)) {
+        return usageError("--streaming doesn't support --window or --buckets");
+    }
+    if (followInterval and (streaming or fromSnapshot or !saveSnapshotFile.empty())) {
+        return usageError("--follow reads the data file itself, and only that");
+    }
+    if (!serveSocket.empty() and (streaming or fromSnapshot or !saveSnapshotFile.empty() or window or bucketWidth > 0 or followInterval)) {
+        return usageError("--serve only takes --threads");
+    }
+    if (coalescing != ChargingNetwork::EventCoalescing::NONE and (streaming or fromSnapshot or followInterval or !serveSocket.empty())) {
+        return usageError("--coalesce doesn't apply to --streaming, --snapshot, --follow or --serve");
+    }
+    if (runStats and (followInterval or !serveSocket.empty() or !querySocket.empty())) {
+        return usageError("--stats only applies to a single report");
+    }
+    if (reportFormat != ReportWriter::Format::TEXT and (bucketWidth > 0 or followInterval)) {
+        return usageError("--buckets and --follow only write text");
+    }
+    if (window and bucketWidth > 0) {
+        return usageError("--window and --buckets can't be combined");
     }
 
-    const std::filesystem::path  chargingNetworkDataFile {argv[1]};
-    Debug( "data file path: " << chargingNetworkDataFile << "\n" );
+    if (!querySocket.empty()) {
+        const string query = (arg < argc) ? argv[arg] : "";
+        const bool takesID = (query == "station" or query == "charger");
+        if (!(takesID ? arg + 2 == argc : (arg + 1 == argc and (query == "report" or query == "reload")))) {
+            return usageError("Invalid query");
+        }
+        uint32_t id {0};
+        if (takesID) {
+            try {
+                //station and charger IDs are 32 bits; stoul would wrap "-1" and truncate anything wider
+                id = parseUnsigned(argv[arg + 1], UINT32_MAX);
+            } catch (std::exception&) {
+                return usageError("Invalid " + query + " ID: " + argv[arg + 1]);
+            }
+        }
+        try {
+            ReportClient client {querySocket};
+            if (query == "report") {
+                print(client.getReport(), reportFormat);
+            } else if (query == "reload") {
+                if (!client.reload()) {
+                    return runError("The server could not reload its data file");
+                }
+            } else {
+                const std::optional<float> uptime = (query == "station") ? client.getStationUptime(id) : client.getChargerUptime(id);
+                if (!uptime) {
+                    return runError("No such " + query + ": " + argv[arg + 1]);
+                }
+                ReportWriter(cout, reportFormat).write(StationAvailabilityEntry(id, *uptime)); //the same as a report line
+            }
+        } catch (std::exception& ex) {
+            return runError(ex.what());
+        }
+        return EXIT_SUCCESS;
+    }
+
+    if (arg == argc ) { //if no data file specified
+        return usageError("No data file specified");
+    }
+
+    const std::filesystem::path  chargingNetworkDataFile {argv[arg]};
 
     int returnCode = EXIT_SUCCESS; //default
+    RunStats* const stats = runStats ? &*runStats : nullptr;
+
+    //Write a report to stdout, as the output phase
+    auto output = [stats, reportFormat] (const auto& report) {
+        RunStats::Scope phase {stats, "output"};
+        if (!phase) {
+            print(report, reportFormat);
+            return;
+        }
+        CountingBuffer counter {cout.rdbuf()};
+        std::streambuf* const original = cout.rdbuf(&counter);
+        print(report, reportFormat);
+        cout << std::flush;
+        cout.rdbuf(original);
+        phase.count(counter.lines, 0, counter.bytes);
+    };
+
+    //The report for whatever the network holds, as asked for on the command line
+    auto writeReport = [&] (const ChargingNetwork& cn) {
+        if (bucketWidth > 0) {
+            std::optional<RunStats::Scope> phase {std::in_place, stats, "report buckets"};
+            const UptimeSeriesReport report = cn.getUptimeSeriesReport(bucketWidth, threadCount);
+            phase.reset();
+            output(report);
+        } else if (window) {
+            std::optional<RunStats::Scope> phase {std::in_place, stats, "report window"};
+            const StationAvailabilityReport report = cn.getStationAvailabilityReport(window->first, window->second);
+            phase.reset();
+            output(report);
+        } else {
+            output(cn.getStationAvailabilityReport(threadCount, stats));
+        }
+    };
 
     try {
-        ChargingNetwork cn {chargingNetworkDataFile};
-        StationAvailabilityReport report = cn.getStationAvailabilityReport();
-        cout << report;
-    } catch (std::exception& ex) {
+        if (!serveSocket.empty()) {
+            std::optional<ReportServer> server;
+            try {
+                server.emplace(chargingNetworkDataFile, serveSocket, 0, threadCount);
+            } catch (std::filesystem::filesystem_error&) {
+                throw; //the data file, reported where it was thrown
+            } catch (std::system_error& ex) { //the socket
+                return runError(ex.what());
+            }
+            runningServer = &*server;
+            std::signal(SIGINT, handleServerSignal);
+            std::signal(SIGTERM, handleServerSignal);
+            std::signal(SIGHUP, handleServerSignal);
+            server->run();
+            runningServer = nullptr;
+        } else if (followInterval) {
+            DataFileFollower follower {chargingNetworkDataFile, threadCount};
+            for (bool changed = true; ; changed = follower.poll()) {
+                if (changed) {
+                    writeReport(follower.getNetwork());
+                    //a blank line ends each report. The uptime report leaves off its last newline.
+                    cout << (bucketWidth > 0 ? "\n" : "\n\n") << std::flush;
+                }
+                std::this_thread::sleep_for(*followInterval);
+            }
+        } else if (streaming) {
+            StreamingUptimeEngine streamingEngine;
+            std::optional<RunStats::Scope> phase {std::in_place, stats, "stream"};
+            const StationAvailabilityReport report = streamingEngine.run(chargingNetworkDataFile);
+            std::error_code ec;
+            const auto bytes = std::filesystem::file_size(chargingNetworkDataFile, ec);
+            if (!ec) {
+                phase->count(0, 0, bytes);
+            }
+            phase.reset();
+            output(report);
+        } else {
+            std::optional<RunStats::Scope> load;
+            if (fromSnapshot) {
+                load.emplace(stats, "snapshot load");
+            }
+            ChargingNetwork cn = fromSnapshot ? NetworkSnapshot::load(chargingNetworkDataFile, snapshotVerification)
+                                              : ChargingNetwork {chargingNetworkDataFile, engine, threadCount, coalescing, stats};
+            if (load and *load) {
+                load->count(0, cn.getEventCount(), 0);
+            }
+            load.reset();
+            if (!saveSnapshotFile.empty()) {
+                RunStats::Scope phase {stats, "snapshot save"};
+                try {
+                    NetworkSnapshot::save(cn, saveSnapshotFile);
+                } catch (std::filesystem::filesystem_error& ex) {
+                    returnCode = runError(ex.what()); //stdout is a report or ERROR, never both
+                }
+            }
+            if (returnCode == EXIT_SUCCESS) {
+                writeReport(cn);
+            }
+        }
+    } catch (std::length_error& ex) { //e.g. --buckets far narrower than the data's time span
+        returnCode = runError(ex.what());
+    } catch (std::bad_alloc&) {
+        returnCode = runError("Out of memory");
+    } catch (std::exception& ex) { //reported where it was thrown
         returnCode = EXIT_FAILURE;
     }
 
+    if (runStats) {
+        runStats->writeJson(std::cerr); //stdout is the report, and only the report
+    }
+
 
     return returnCode; //success/failure See Spec Section 2.3.3
 
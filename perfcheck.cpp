@@ -0,0 +1,348 @@
+// Check the throughput of reading a data file and making its report against a committed baseline.
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+using std::string;
+#include <vector>
+using std::vector;
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <regex>
+
+#include "Benchmarking.h"
+#include "ChargingNetwork.h"
+#include "StationAvailabilityReportFactory.h"
+#include "SyntheticNetworkGenerator.h"
+
+using namespace Charging;
+
+namespace {
+
+using Distribution = SyntheticNetworkGenerator::ChargerDistribution;
+using UptimeEngine = StationAvailabilityReportFactory::UptimeEngine;
+
+/**
+ * @brief A generated data file of a fixed shape. Changing one invalidates the baseline.
+ */
+struct Workload {
+    string name;
+    SyntheticNetworkGenerator::Options options;
+};
+
+/**
+ * @brief Three shapes of about 200,000 events each: the typical one, a few Stations with very
+ * many Chargers, and reports mostly overlapping and out of order.
+ */
+vector<Workload> workloads() {
+    vector<Workload> workloads {{"typical", {}}, {"fanout", {}}, {"overlap", {}}};
+    auto& typical = workloads[0].options;
+    typical.stationCount = 2000;
+    typical.distribution = Distribution::UNIFORM;
+    typical.chargersPerStation = 4;
+    typical.eventsPerCharger = 25;
+    auto& fanout = workloads[1].options;
+    fanout.stationCount = 10;
+    fanout.chargersPerStation = 500;
+    fanout.eventsPerCharger = 40;
+    auto& overlap = workloads[2].options;
+    overlap.stationCount = 1000;
+    overlap.chargersPerStation = 2;
+    overlap.eventsPerCharger = 100;
+    overlap.overlapRate = 0.9;
+    overlap.sortedness = 0.5;
+    return workloads;
+}
+
+/**
+ * @brief Throughput of one stage over one workload.
+ */
+struct Result {
+    string workload;
+    string stage;
+    std::size_t events {0};
+    double eventsPerSecond {0};
+    double normalized {0};          ///< events per calibration run's time: events / (seconds / calibration seconds)
+};
+
+//Each stage is timed over at least MIN_ROUNDS rounds, and more until MIN_SECONDS have gone by.
+//Constructing is timed over more: page faults and allocation make it the noisiest stage.
+constexpr unsigned MIN_ROUNDS {15};
+constexpr unsigned MIN_CONSTRUCT_ROUNDS {31};
+constexpr double MIN_SECONDS {0.5};
+
+//--update takes the median of this many passes over every workload
+constexpr unsigned UPDATE_PASSES {5};
+
+/**
+ * @brief The median of some values.
+ */
+double median ( vector<double> values ) {
+    std::sort ( values.begin(), values.end() );
+    const std::size_t middle = values.size() / 2;
+    return ( values.size() % 2 ) ? values[middle] : ( values[middle - 1] + values[middle] ) / 2;
+}
+
+/**
+ * @brief A fixed piece of work of the same kind as the pipeline's: sorting, and inserting into a
+ * std::map. Stages are timed relative to how fast this machine does it, so that a baseline taken
+ * on one machine roughly holds on another, and on the same machine while it's busy.
+ */
+class Calibration
+{
+public:
+    Calibration();
+
+    /**
+     * @brief Run the calibration work once.
+     */
+    void operator() () const;
+
+private:
+    vector<uint64_t> values;
+};
+
+Calibration::Calibration() : values ( 1 << 18 ) {
+    SplitMix64 random {1};
+    for ( auto& value : values )
+        value = random.next();
+}
+
+void Calibration::operator() () const {
+    vector<uint64_t> sorting = this->values;
+    std::sort ( sorting.begin(), sorting.end() );
+    std::map<uint64_t, uint64_t> tree;
+    for ( std::size_t i = 0; i < this->values.size(); i += 8 )
+        tree.emplace ( this->values[i], i );
+    sink = sink + sorting.front() + tree.size();
+}
+
+/**
+ * @brief Median time of work(), absolute and relative to the calibration.
+ */
+struct Timing {
+    double seconds {0};
+    double relative {0};            ///< work's time divided by the calibration's
+    double calibrationSeconds {0};
+};
+
+/**
+ * @brief Time work() over at least minRounds rounds. Each round runs the calibration and then
+ * work(), back to back, so both see the machine in the same state: a build starting up halfway
+ * thru slows both, and their ratio holds. The medians are kept, which one disturbed round
+ * doesn't move.
+ */
+Timing timeRelative ( const Calibration& calibration, const std::function<void()>& work, unsigned minRounds ) {
+    vector<double> seconds, relative, calibrationSeconds;
+    double total {0};
+    for ( unsigned rounds = 0; rounds < minRounds or total < MIN_SECONDS; ++rounds ) {
+        const double calibrated = timeOnce ( calibration );
+        const double took = timeOnce ( work );
+        seconds.push_back ( took );
+        relative.push_back ( took / calibrated );
+        calibrationSeconds.push_back ( calibrated );
+        total += took + calibrated;
+    }
+    return {median ( seconds ), median ( relative ), median ( calibrationSeconds )};
+}
+
+/**
+ * @brief Time the ChargingNetwork constructor and getReport(), on each UptimeEngine, over a
+ * workload.
+ *
+ * @param calibrationSeconds set to the calibration's median time, for the baseline
+ */
+vector<Result> measure ( const Workload& workload, const Calibration& calibration, double& calibrationSeconds ) {
+    const auto path = std::filesystem::temp_directory_path() / ( "electra2_perfcheck_" + workload.name + ".txt" );
+    {
+        std::ofstream ofs {path, std::ios::binary};
+        SyntheticNetworkGenerator {workload.options}.write ( ofs );
+    }
+    vector<Result> results;
+    auto record = [&] ( const string& stage, std::size_t events, const Timing& timing ) {
+        results.push_back ( {workload.name, stage, events, events / timing.seconds, events / timing.relative} );
+        calibrationSeconds = timing.calibrationSeconds;
+    };
+
+    const ChargingNetwork network {path, ChargingNetwork::IngestionEngine::MAPPED, 1};
+    const std::size_t events = network.getEventCount();
+    record ( "construct", events, timeRelative ( calibration, [&path] () {
+        const ChargingNetwork cn {path, ChargingNetwork::IngestionEngine::MAPPED, 1};
+        sink = sink + cn.getStations().size();
+    }, MIN_CONSTRUCT_ROUNDS ) );
+    std::filesystem::remove ( path );
+
+    for ( const auto& [stage, engine] : {std::pair {"report kway", UptimeEngine::KWAY_MERGE},
+                                         {"report consolidate", UptimeEngine::CONSOLIDATE_SORT}} ) {
+        record ( stage, events, timeRelative ( calibration, [&network, engine] () {
+            StationAvailabilityReportFactory factory {network.getStations(), 1, engine};
+            sink = sink + factory.getReport().getEntries().size();
+        }, MIN_ROUNDS ) );
+    }
+    return results;
+}
+
+/**
+ * @brief Write a baseline: the calibration, then a result per line.
+ */
+void writeBaseline ( const std::filesystem::path& path, double calibrationSeconds, const vector<Result>& results ) {
+    std::ofstream ofs {path};
+    if ( !ofs )
+        throw std::runtime_error ( "Could not write " + path.string() );
+    ofs << "{\n\"calibration_seconds\":" << calibrationSeconds << ",\n\"results\":[\n";
+    for ( std::size_t i = 0; i < results.size(); ++i ) {
+        const Result& r = results[i];
+        ofs << "{\"workload\":\"" << r.workload << "\",\"stage\":\"" << r.stage << "\",\"events\":" << r.events
+            << ",\"events_per_second\":" << r.eventsPerSecond << ",\"normalized\":" << r.normalized << "}"
+            << ( i + 1 < results.size() ? "," : "" ) << "\n";
+    }
+    ofs << "]\n}\n";
+}
+
+/**
+ * @brief Read a baseline written by writeBaseline(). Only that layout, a result per line, is
+ * understood.
+ */
+vector<Result> readBaseline ( const std::filesystem::path& path ) {
+    std::ifstream ifs {path};
+    if ( !ifs )
+        throw std::runtime_error ( "Could not read " + path.string() );
+    static const std::regex resultLine {R"re(\{"workload":"([^"]+)","stage":"([^"]+)","events":(\d+),"events_per_second":([^,]+),"normalized":([^}]+)\}.*)re"};
+    vector<Result> results;
+    std::smatch match;
+    for ( string line; std::getline ( ifs, line ); ) {
+        if ( std::regex_match ( line, match, resultLine ) )
+            results.push_back ( {match[1], match[2], std::stoull ( match[3] ), std::stod ( match[4] ), std::stod ( match[5] )} );
+    }
+    if ( results.empty() )
+        throw std::runtime_error ( "No results in " + path.string() );
+    return results;
+}
+
+} //namespace
+
+/**
+ * @brief Entry point for electra2_perfcheck, the performance regression test.
+ * Generates fixed workloads and times the ChargingNetwork constructor and
+ * StationAvailabilityReportFactory::getReport() on each UptimeEngine over them, as events per
+ * second. Each stage is timed in rounds alongside a fixed calibration, and its median time
+ * relative to the calibration's is compared with the baseline's: if throughput has fallen by
+ * more than the tolerance, the check fails.
+ * Registered with ctest in Release builds configured with ELECTRA2_PERF_TEST=ON.
+ *
+ * Options:
+ *
+ *      --baseline FILE     The baseline to compare with. Required.
+ *      --tolerance F       The fraction throughput may fall by, 0 to 1. Default 0.25.
+ *      --update            Write the median of several passes to the baseline instead of
+ *                          comparing. For after a change that's meant to be faster, or the
+ *                          workloads changing.
+ *
+ * @param argc The number of arguments passed on the command line
+ * @param argv The arguments
+ * @return int EXIT_FAILURE if any throughput regressed, or the workloads no longer match the baseline
+ */
+int main(int argc, char **argv) {
+
+    auto usageError = [argv] (const string& explanation) {
+        std::cerr << explanation << "\n";
+        std::cerr << "Usage: " << argv[0] << " --baseline FILE [--tolerance 0.25] [--update]\n";
+        return EXIT_FAILURE;
+    };
+
+    std::filesystem::path baselineFile;
+    double tolerance {0.25};
+    bool update {false};
+    for (int arg = 1; arg < argc; ++arg) {
+        const string option {argv[arg]};
+        try {
+            if (option == "--baseline" and arg + 1 < argc) {
+                baselineFile = argv[++arg];
+            } else if (option == "--tolerance" and arg + 1 < argc) {
+                tolerance = std::stod(argv[++arg]);
+                if (tolerance < 0.0 or tolerance > 1.0)
+                    throw std::out_of_range(argv[arg]);
+            } else if (option == "--update") {
+                update = true;
+            } else {
+                return usageError("Unknown option: " + option);
+            }
+        } catch (const std::logic_error&) {
+            return usageError("Invalid value for " + option + ": " + argv[arg]);
+        }
+    }
+    if (baselineFile.empty()) {
+        return usageError("No baseline specified");
+    }
+
+    try {
+        const Calibration calibration;
+        double calibrationSeconds {0};
+        auto measureAll = [&calibration, &calibrationSeconds] () {
+            vector<Result> results;
+            for (const Workload& workload : workloads()) {
+                auto workloadResults = measure(workload, calibration, calibrationSeconds);
+                results.insert(results.end(), workloadResults.begin(), workloadResults.end());
+            }
+            return results;
+        };
+
+        if (update) {
+            //a baseline is compared with for a long time, so it's the median of several passes, not one
+            vector<vector<Result>> passes;
+            vector<double> passCalibrations;
+            for (unsigned pass = 0; pass < UPDATE_PASSES; ++pass) {
+                passes.push_back(measureAll());
+                passCalibrations.push_back(calibrationSeconds);
+            }
+            vector<Result> results = passes.front();
+            for (std::size_t i = 0; i < results.size(); ++i) {
+                vector<double> eventsPerSecond, normalized;
+                for (const auto& pass : passes) {
+                    eventsPerSecond.push_back(pass[i].eventsPerSecond);
+                    normalized.push_back(pass[i].normalized);
+                }
+                results[i].eventsPerSecond = median(eventsPerSecond);
+                results[i].normalized = median(normalized);
+            }
+            writeBaseline(baselineFile, median(passCalibrations), results);
+            std::cout << "Wrote the median of " << UPDATE_PASSES << " passes, " << results.size() << " results, to " << baselineFile.string() << "\n";
+            return EXIT_SUCCESS;
+        }
+
+        const vector<Result> results = measureAll();
+
+        const vector<Result> baseline = readBaseline(baselineFile);
+        int returnCode = EXIT_SUCCESS;
+        std::printf("%-10s %-20s %10s %14s %14s %9s\n", "workload", "stage", "events", "baseline ev/s", "events/s", "change");
+        for (const Result& result : results) {
+            const auto expected = std::find_if(baseline.begin(), baseline.end(), [&result] (const Result& b) {
+                return b.workload == result.workload and b.stage == result.stage;
+            });
+            if (expected == baseline.end() or expected->events != result.events) {
+                std::printf("%-10s %-20s %10zu  not in the baseline, or not the same workload: run with --update\n",
+                            result.workload.c_str(), result.stage.c_str(), result.events);
+                returnCode = EXIT_FAILURE;
+                continue;
+            }
+            //as measured here, scaled by how much faster or slower this machine is than the baseline's
+            const double change = result.normalized / expected->normalized - 1.0;
+            const bool regressed = change < -tolerance;
+            std::printf("%-10s %-20s %10zu %14.0f %14.0f %+8.1f%%%s\n", result.workload.c_str(), result.stage.c_str(),
+                        result.events, expected->eventsPerSecond, result.eventsPerSecond, change * 100,
+                        regressed ? "  REGRESSED" : "");
+            if (regressed)
+                returnCode = EXIT_FAILURE;
+        }
+        return returnCode;
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << "\n";
+        return EXIT_FAILURE;
+    }
+}
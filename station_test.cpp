@@ -5,7 +5,18 @@
 #include <fstream>
 using std::ifstream;
 
+#include <filesystem>
+#include <future>
+#include <numeric>
+#include <sstream>
+
 #include <string>
+#include <thread>
+#include <tuple>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
 using std::string;
 
 #include <iostream>
@@ -13,8 +24,28 @@ using std::cout;
 
 #include "ChargingNetwork.h"
 #include "Station.h"
+#include "StationAvailabilityReportFactory.h"
 
 #include "AvailabilityEvent.h"
+#include "AvailabilityEventStore.h"
+#include "DataFileParser.h"
+#include "IntervalSort.h"
+#include "IntervalUnion.h"
+#include "NetworkSnapshot.h"
+#include "SortedRunMerger.h"
+#include "StreamingUptimeEngine.h"
+#include "UptimeSeriesReport.h"
+#include "OptionParsing.h"
+#include "DataFileFollower.h"
+#include "DenseIdMap.h"
+#include "NetworkArena.h"
+#include "ReportClient.h"
+#include "ReportServer.h"
+#include "SyntheticNetworkGenerator.h"
+#include "RunStats.h"
+#include "AllocationTracker.h"
+#include "ReportWriter.h"
+#include "Tracer.h"
 
 namespace Charging {
 
@@ -149,5 +180,777 @@ TEST ( ChargersOperatorLeftBitShift, MultiTest ) {
     cout << v;
 }
 
+TEST ( ChargingNetwork, MappedMatchesStreamTest ) {
+    for ( const string inputFile : {"../data/input_1.txt", "../data/input_2.txt", "../data/input_3.txt",
+                                    "../data/input_4.txt", "../data/input_5.txt", "../data/random_binary_file"} ) {
+        ChargingNetwork mapped {inputFile, ChargingNetwork::IngestionEngine::MAPPED};
+        ChargingNetwork streamed {inputFile, ChargingNetwork::IngestionEngine::STREAM};
+        ASSERT_TRUE( mapped.getStationAvailabilityReport() == streamed.getStationAvailabilityReport() ) << inputFile;
+    }
+}
+
+TEST ( ChargingNetwork, MappedNotExistTest ) {
+    ASSERT_THROW( ChargingNetwork {"../data/input_notexist.txt"}, std::filesystem::filesystem_error );
+}
+
+//Write a data file big enough to be split into several chunks by the PARALLEL engine
+static std::filesystem::path writeLargeDataFile ( const string& name, bool trailingStations ) {
+    const auto path = std::filesystem::temp_directory_path() / name;
+    std::ofstream ofs {path};
+    ofs << "[Stations]\n";
+    for ( int station = 0; station < 50; station++ ) {
+        ofs << station << " " << 1000 + 2 * station << " " << 1001 + 2 * station << "\n";
+    }
+    ofs << "\n[Charger Availability Reports]\n";
+    for ( uint64_t i = 0; i < 200000; i++ ) {
+        const auto start = i * 10;
+        ofs << 1000 + ( i * 31 ) % 100 << ( i % 2 ? "\t" : " " ) << start << " " << start + i % 7
+            << " " << ( i % 3 ? "true" : "false" ) << "\n";
+    }
+    if ( trailingStations ) {
+        ofs << "[Stations]\n" << "99 2000\n";
+    }
+    return path;
+}
+
+TEST ( ChargingNetwork, ParallelMatchesMappedTest ) {
+    for ( const bool trailingStations : {false, true} ) {
+        const auto path = writeLargeDataFile ( "electra2_parallel_test.txt", trailingStations );
+        ChargingNetwork mapped {path, ChargingNetwork::IngestionEngine::MAPPED};
+        for ( const unsigned threads : {2u, 3u, 8u} ) {
+            ChargingNetwork parallel {path, ChargingNetwork::IngestionEngine::PARALLEL, threads};
+            ASSERT_TRUE( mapped.getStationAvailabilityReport() == parallel.getStationAvailabilityReport() );
+        }
+        std::filesystem::remove ( path );
+    }
+}
+
+TEST ( StationAvailabilityReportFactory, ParallelMatchesSerialTest ) {
+    for ( const string inputFile : {"../data/input_1.txt", "../data/input_2.txt", "../data/input_5.txt"} ) {
+        ChargingNetwork cn {inputFile};
+        ASSERT_TRUE( cn.getStationAvailabilityReport ( 4 ) == cn.getStationAvailabilityReport() ) << inputFile;
+    }
+    const auto path = writeLargeDataFile ( "electra2_parallel_report_test.txt", true );
+    ChargingNetwork cn {path};
+    const auto serial = cn.getStationAvailabilityReport();
+    for ( const unsigned threads : {2u, 3u, 8u} ) {
+        ASSERT_TRUE( cn.getStationAvailabilityReport ( threads ) == serial );
+    }
+    std::filesystem::remove ( path );
+}
+
+TEST ( AvailabilityEventStore, PushBackTest ) {
+    AvailabilityEventStore store;
+    for ( uint64_t i = 0; i < 130; i++ ) {
+        store.push_back ( i, i + 10, i % 3 == 0 );
+    }
+    ASSERT_EQ( store.size(), 130u );
+    for ( uint64_t i = 0; i < 130; i++ ) {
+        ASSERT_TRUE( store[i] == AvailabilityEvent( i, i + 10, i % 3 == 0 ) );
+    }
+    ASSERT_EQ( std::ranges::count_if ( store, [] ( const AvailabilityEvent& ae ) { return ae.available; } ), 44 );
+}
+
+TEST ( AvailabilityEventStore, AppendTest ) {
+    AvailabilityEventStore expected, a, b;
+    for ( uint64_t i = 0; i < 100; i++ ) {
+        expected.push_back ( i, i + 1, i % 2 == 0 );
+        ( i < 70 ? a : b ).push_back ( i, i + 1, i % 2 == 0 );
+    }
+    a.append ( b );
+    ASSERT_TRUE( a == expected );
+}
+
+TEST ( IntervalUnion, InsertTest ) {
+    IntervalUnion u;
+    u.insert ( 0, 100 );
+    u.insert ( 50, 150 );
+    u.insert ( 200, 300 );
+    u.insert ( 60, 120 );   //inside [0, 150)
+    u.insert ( 400, 400 );  //empty
+    ASSERT_EQ( u.coveredLength(), 250u );
+    ASSERT_EQ( u.size(), 2u );
+    u.insert ( 150, 200 );  //fills the gap exactly
+    ASSERT_EQ( u.coveredLength(), 300u );
+    ASSERT_EQ( u.size(), 1u );
+    u.insert ( 500, 600 );
+    u.insert ( 10, 1000 );  //swallows everything
+    ASSERT_EQ( u.coveredLength(), 1000u );
+    ASSERT_EQ( u.size(), 1u );
+}
+
+TEST ( StreamingUptimeEngine, MatchesChargingNetworkTest ) {
+    for ( const string inputFile : {"../data/input_1.txt", "../data/input_2.txt", "../data/input_3.txt",
+                                    "../data/input_4.txt", "../data/input_5.txt", "../data/random_binary_file"} ) {
+        ChargingNetwork cn {inputFile};
+        StreamingUptimeEngine engine;
+        ASSERT_TRUE( engine.run ( inputFile ) == cn.getStationAvailabilityReport() ) << inputFile;
+    }
+    const auto path = writeLargeDataFile ( "electra2_streaming_test.txt", true );
+    ChargingNetwork cn {path};
+    StreamingUptimeEngine engine;
+    ASSERT_TRUE( engine.run ( path ) == cn.getStationAvailabilityReport() );
+    std::filesystem::remove ( path );
+}
+
+TEST ( RunStats, PhasesTest ) {
+    using Engine = ChargingNetwork::IngestionEngine;
+    const auto fileSize = std::filesystem::file_size ( "../data/input_1.txt" );
+    for ( const auto engine : {Engine::STREAM, Engine::MAPPED} ) {
+        RunStats stats;
+        const ChargingNetwork cn {"../data/input_1.txt", engine, 1, ChargingNetwork::EventCoalescing::NONE, &stats};
+        ASSERT_TRUE( cn.getStationAvailabilityReport ( 1, &stats ) == cn.getStationAvailabilityReport() );
+
+        const auto& phases = stats.getPhases();
+        vector<string> names;
+        for ( const auto& phase : phases )
+            names.push_back ( phase.name );
+        ASSERT_EQ( names, ( vector<string> {"open", "stations", "availability", "report merge", "report sort"} ) );
+        ASSERT_EQ( phases[1].bytes + phases[2].bytes, fileSize ); //every byte read once
+        ASSERT_EQ( phases[1].lines + phases[2].lines, 12u ); //the last without a newline
+        ASSERT_EQ( phases[2].events, cn.getEventCount() );
+        ASSERT_EQ( phases[3].events, cn.getEventCount() );
+        ASSERT_GT( phases[4].peakRSS, 0 );
+
+        std::ostringstream json;
+        stats.writeJson ( json );
+        ASSERT_TRUE( json.str().starts_with ( "{\"phases\":[{\"name\":\"open\"," ) );
+        ASSERT_TRUE( json.str().ends_with ( "}\n" ) );
+    }
+}
+
+TEST ( AllocationTracker, PhasesTest ) {
+    {
+        RunStats untracked;
+        RunStats::Scope {&untracked, "untracked"};
+        ASSERT_FALSE( untracked.getPhases()[0].allocations );
+    }
+    RunStats stats;
+    {
+        AllocationTracker tracker;
+        ASSERT_THROW( AllocationTracker {}, std::logic_error );
+        {
+            RunStats::Scope outer {&stats, "outer"};
+            auto big = std::make_unique<std::vector<char>> ( 1 << 20 );
+            big.reset();
+            RunStats::Scope inner {&stats, "inner"};
+            const std::vector<char> small ( 1000 );
+        }
+        const ChargingNetwork cn {"../data/input_1.txt", ChargingNetwork::IngestionEngine::STREAM, 1,
+                                  ChargingNetwork::EventCoalescing::NONE, &stats};
+        cn.getStationAvailabilityReport ( 1, &stats );
+    }
+    ASSERT_FALSE( AllocationTracker::isTracking() );
+
+    const auto& phases = stats.getPhases();
+    ASSERT_EQ( phases[0].name, "outer" );
+    ASSERT_GE( phases[0].allocations->count, 3u ); //the vector, its elements, the small vector, and the inner phase's slot
+    ASSERT_GE( phases[0].allocations->bytes, ( 1u << 20 ) + 1000 );
+    ASSERT_GE( phases[0].allocations->peakLiveBytes, 1 << 20 ); //the inner phase doesn't hide it
+    ASSERT_EQ( phases[1].name, "inner" );
+    ASSERT_EQ( phases[1].allocations->count, 1u );
+    ASSERT_LT( phases[1].allocations->peakLiveBytes, 1 << 20 );
+    for ( const auto& phase : phases ) {
+        ASSERT_TRUE( phase.allocations );
+        if ( phase.name == "stations" or phase.name == "availability" or phase.name == "report merge" ) {
+            ASSERT_GT( phase.allocations->count, 0u );
+        }
+    }
+
+    std::ostringstream json;
+    stats.writeJson ( json );
+    ASSERT_NE( json.str().find ( "\"allocations\":" ), string::npos );
+}
+
+TEST ( ReportWriter, FormatsTest ) {
+    using Format = ReportWriter::Format;
+    StationAvailabilityReport report;
+    report += StationAvailabilityEntry ( 0, 1.0f );
+    report += StationAvailabilityEntry ( 7, 0.125f );
+    auto written = [&report] ( Format format ) {
+        std::ostringstream os;
+        ReportWriter ( os, format ).write ( report );
+        return os.str();
+    };
+    ASSERT_EQ( written ( Format::TEXT ), "0 100\n7 12" );
+    ASSERT_EQ( written ( Format::CSV ), "station_id,uptime_percent\n0,100\n7,12\n" );
+    ASSERT_EQ( written ( Format::JSONL ), "{\"station_id\":0,\"uptime_percent\":100}\n{\"station_id\":7,\"uptime_percent\":12}\n" );
+    const string binary = written ( Format::BINARY );
+    ASSERT_EQ( binary.size(), 8 + 2 * ReportWriter::BINARY_RECORD_SIZE );
+    ASSERT_EQ( binary.substr ( 0, 8 ), string ( "E2RP\x01\0\0\0", 8 ) );
+    ASSERT_EQ( binary.substr ( 16, 8 ), string ( "\x07\0\0\0\0\0\0\x3e", 8 ) ); //0.125f is 0x3e000000
+
+    std::ostringstream os; //operator<< writes to the stream it's given, not to cout
+    os << report;
+    ASSERT_EQ( os.str(), written ( Format::TEXT ) );
+
+    //a big report goes to the stream in one write
+    class WriteCounter : public std::streambuf
+    {
+    public:
+        int writes {0};
+    protected:
+        std::streamsize xsputn ( const char*, std::streamsize n ) override { ++this->writes; return n; }
+        int_type overflow ( int_type c ) override { ++this->writes; return c; }
+    } counter;
+    std::ostream counted {&counter};
+    StationAvailabilityReport big;
+    for ( ChargingNodes::stationID_t stationID = 0; stationID < 300'000; ++stationID )
+        big += StationAvailabilityEntry ( stationID, 0.5f );
+    counted << big;
+    ASSERT_EQ( counter.writes, 1 );
+}
+
+TEST ( Tracer, SessionTest ) {
+    std::ostringstream sink;
+    ChargingNetwork {"../data/input_1.txt"}; //no Session, so nothing is recorded
+    {
+        Tracer::Session session {sink};
+        ASSERT_THROW( Tracer::Session {sink}, std::logic_error ); //one at a time
+        const ChargingNetwork cn {"../data/input_1.txt", ChargingNetwork::IngestionEngine::STREAM};
+        cn.getStationAvailabilityReport ( 2 ); //and from the report's threads
+        std::thread ( [] () { Trace( MERGE, INFO, "from another thread", 7 ); } ).join();
+    }
+    const string trace = sink.str();
+    ASSERT_EQ( std::ranges::count ( trace, '\n' ), 21 );
+    ASSERT_NE( trace.find ( " parse debug availability header: line: 6\n" ), string::npos );
+    ASSERT_NE( trace.find ( " parse verbose station charger: 0 1002\n" ), string::npos );
+    ASSERT_NE( trace.find ( " parse info network read: stations, chargers: 3 4\n" ), string::npos );
+    ASSERT_NE( trace.find ( " report debug station uptime: station, percent: 2 75\n" ), string::npos );
+    ASSERT_NE( trace.find ( " merge info from another thread: 7\n" ), string::npos );
+}
+
+//Station 0: an interval which was trimmed against an earlier one, followed by one it already
+//covers. removeOverlaps() used to trim the latter to a negative length.
+//Station 1: two intervals with the same start. removeOverlaps() used to drop the longer one.
+TEST ( StationAvailabilityReportFactory, OverlapEdgeCasesTest ) {
+    std::istringstream iss {"[Stations]\n0 1 2 3\n1 4 5\n\n[Charger Availability Reports]\n"
+                            "1 0 100 true\n2 50 150 true\n3 60 120 true\n"
+                            "4 0 10 true\n5 0 20 true\n5 20 40 false\n"};
+    StreamingUptimeEngine engine;
+    engine.consume ( iss );
+    StationAvailabilityReport expected;
+    expected += StationAvailabilityEntry ( 0, 1.0f );
+    expected += StationAvailabilityEntry ( 1, 0.5f );
+    ASSERT_TRUE( engine.getReport() == expected );
+
+    const auto path = std::filesystem::temp_directory_path() / "electra2_covered_test.txt";
+    std::ofstream {path} << iss.str();
+    ChargingNetwork cn {path};
+    ASSERT_TRUE( cn.getStationAvailabilityReport() == expected );
+    std::filesystem::remove ( path );
+}
+
+TEST ( SortedRunMerger, MatchesIntervalUnionTest ) {
+    //three Chargers: in order, out of order, and in order with long stretches of downtime
+    vector<AvailabilityEventStore> chargers ( 3 );
+    IntervalUnion expected;
+    uint64_t seed {12345};
+    auto next = [&seed] ( uint64_t bound ) { seed = seed * 6364136223846793005u + 1442695040888963407u; return ( seed >> 33 ) % bound; };
+    for ( uint64_t i = 0; i < 500; i++ ) {
+        const uint64_t start0 = i * 100 + next ( 50 ), start1 = next ( 50000 ), start2 = i * 97;
+        const bool available2 = ( i / 70 ) % 2 == 0;
+        chargers[0].push_back ( start0, start0 + next ( 200 ), true );
+        chargers[1].push_back ( start1, start1 + next ( 300 ), i % 4 != 0 );
+        chargers[2].push_back ( start2, start2 + 40, available2 );
+    }
+    SortedRunMerger merger;
+    ASSERT_TRUE( merger.addRun ( chargers[0] ) );
+    ASSERT_FALSE( merger.addRun ( chargers[1] ) );
+    ASSERT_TRUE( merger.addRun ( chargers[2] ) );
+    for ( const auto& charger : chargers ) {
+        for ( const auto ae : charger ) {
+            if ( ae.available )
+                expected.insert ( ae.startTime, ae.endTime );
+        }
+    }
+    ASSERT_EQ( merger.coveredLength(), expected.coveredLength() );
+}
+
+TEST ( IntervalSort, RadixMatchesComparisonTest ) {
+    uint64_t seed {777};
+    auto next = [&seed] () { seed = seed * 6364136223846793005u + 1442695040888963407u; return seed >> 11; };
+    //wide keys, narrow keys (most passes skipped) and many duplicates
+    for ( const uint64_t range : {UINT64_MAX >> 11, uint64_t {100000}, uint64_t {16}} ) {
+        vector<IntervalSort::Interval> radix;
+        for ( int i = 0; i < 5000; i++ ) {
+            const uint64_t start = 1700000000000000000u + next() % range;
+            radix.push_back ( {start, start + next() % range} );
+        }
+        auto comparison = radix;
+        IntervalSort::sort ( radix, IntervalSort::Algorithm::RADIX );
+        IntervalSort::sort ( comparison, IntervalSort::Algorithm::COMPARISON );
+        ASSERT_TRUE( radix == comparison ) << range;
+        ASSERT_TRUE( std::ranges::is_sorted ( radix ) );
+    }
+}
+
+TEST ( UptimeIndex, WindowTest ) {
+    //Station 0: available [0, 100) and [150, 200), down [100, 150). Station 1: only from 1000.
+    const auto path = std::filesystem::temp_directory_path() / "electra2_window_test.txt";
+    std::ofstream {path} << "[Stations]\n0 1 2\n1 3\n\n[Charger Availability Reports]\n"
+                            "1 0 60 true\n2 40 100 true\n1 100 150 false\n2 150 200 true\n3 1000 2000 true\n";
+    ChargingNetwork cn {path};
+    std::filesystem::remove ( path );
+
+    //the whole span of every Station gives the usual report
+    ASSERT_TRUE( cn.getStationAvailabilityReport ( 0, UINT64_MAX ) == cn.getStationAvailabilityReport() );
+
+    StationAvailabilityReport expected;
+    expected += StationAvailabilityEntry ( 0, 0.5f );   //[50, 150): 50 of 100
+    ASSERT_TRUE( cn.getStationAvailabilityReport ( 50, 150 ) == expected );
+
+
+    StationAvailabilityReport downtime;
+    downtime += StationAvailabilityEntry ( 0, 0.0f );
+    ASSERT_TRUE( cn.getStationAvailabilityReport ( 100, 150 ) == downtime );
+
+    StationAvailabilityReport lateOnly;                  //Station 0 reported nothing after 200
+    lateOnly += StationAvailabilityEntry ( 1, 1.0f );
+    ASSERT_TRUE( cn.getStationAvailabilityReport ( 1500, 3000 ) == lateOnly );
+
+    ASSERT_THROW( cn.getStationAvailabilityReport ( 150, 150 ), std::invalid_argument );
+    ASSERT_THROW( cn.getStationAvailabilityReport ( 150, 50 ), std::invalid_argument );
+}
+
+TEST ( ChargingNetwork, AddAvailabilityEventTest ) {
+    //the same events, some in the file and some added after, give the same report as all in the file
+    const std::string topology {"[Stations]\n0 1 2\n1 3\n2 4\n\n[Charger Availability Reports]\n"};
+    const std::string early {"1 0 60 true\n2 40 100 true\n3 1000 2000 true\n"};
+    const std::string late {"1 100 150 false\n2 120 130 true\n2 50 70 true\n3 500 400 true\n"};
+    const auto path = std::filesystem::temp_directory_path() / "electra2_incremental_test.txt";
+    std::ofstream {path} << topology << early << late;
+    ChargingNetwork all {path};
+    std::ofstream {path} << topology << early;
+    ChargingNetwork cn {path};
+    std::filesystem::remove ( path );
+
+    ASSERT_FALSE( cn.getStationAvailabilityReport() == all.getStationAvailabilityReport() );
+    ASSERT_FALSE( cn.getStationAvailabilityReport ( 0, 120 ) == all.getStationAvailabilityReport ( 0, 120 ) );
+    ASSERT_TRUE( cn.addAvailabilityEvent ( 1, 100, 150, false ) );
+    ASSERT_TRUE( cn.addAvailabilityEvent ( 2, AvailabilityEvent ( 120, 130, true ) ) );
+    ASSERT_TRUE( cn.addAvailabilityEvent ( 2, 50, 70, true ) );
+    ASSERT_TRUE( cn.addAvailabilityEvent ( 3, 500, 400, true ) ); //clamped. See Spec Section 4.3
+    ASSERT_FALSE( cn.addAvailabilityEvent ( 99, 0, 10, true ) );
+
+    ASSERT_TRUE( cn.getStationAvailabilityReport() == all.getStationAvailabilityReport() );
+    ASSERT_TRUE( cn.getStationAvailabilityReport ( 0, 120 ) == all.getStationAvailabilityReport ( 0, 120 ) );
+}
+
+TEST ( ChargingNetwork, CopyThenAddTest ) {
+    //a copy has Chargers of its own: events added to either network leave the other as it was
+    const auto path = std::filesystem::temp_directory_path() / "electra2_copy_test.txt";
+    std::ofstream {path} << "[Stations]\n0 1\n1 2\n\n[Charger Availability Reports]\n1 0 100 true\n2 0 100 true\n";
+    ChargingNetwork original {path};
+    std::filesystem::remove ( path );
+    ASSERT_TRUE( original.addAvailabilityEvent ( 2, 100, 200, false ) ); //incremental totals, copied too
+
+    ChargingNetwork copy {original};
+    ChargingNetwork assigned;
+    assigned = original;
+    ASSERT_TRUE( copy.addAvailabilityEvent ( 1, 100, 150, true ) );
+    ASSERT_TRUE( original.addAvailabilityEvent ( 1, 150, 200, false ) );
+
+    StationAvailabilityReport copyReport;                //station 0 up for all of [0, 150)
+    copyReport += StationAvailabilityEntry ( 0, 1.0f );
+    copyReport += StationAvailabilityEntry ( 1, 0.5f );
+    StationAvailabilityReport originalReport;            //station 0 up for half of [0, 200)
+    originalReport += StationAvailabilityEntry ( 0, 0.5f );
+    originalReport += StationAvailabilityEntry ( 1, 0.5f );
+    StationAvailabilityReport assignedReport;            //neither
+    assignedReport += StationAvailabilityEntry ( 0, 1.0f );
+    assignedReport += StationAvailabilityEntry ( 1, 0.5f );
+
+    for ( const auto& [network, expected, span] : {std::tuple {&copy, &copyReport, 150u}, {&original, &originalReport, 200u},
+                                                   {&assigned, &assignedReport, 100u}} ) {
+        ASSERT_TRUE( network->getStationAvailabilityReport() == *expected );
+        //the incremental totals, the windowed index and the Chargers all agree
+        ASSERT_TRUE( network->getStationAvailabilityReport ( 0, span ).getEntries().front() == expected->getEntries().front() );
+        ASSERT_EQ( network->getChargerUptime ( 1 ), expected->getEntries().front().getUptimeFraction() );
+    }
+    ASSERT_EQ( copy.getChargers().at ( 1 )->getAvailabilityEvents().size(), 2u );
+    ASSERT_EQ( original.getChargers().at ( 1 )->getAvailabilityEvents().size(), 2u );
+    ASSERT_EQ( assigned.getChargers().at ( 1 )->getAvailabilityEvents().size(), 1u );
+}
+
+TEST ( DataFileFollower, PollTest ) {
+    const std::string topology {"[Stations]\n0 1 2\n1 3\n\n[Charger Availability Reports]\n"};
+    const std::string early {"1 0 60 true\n2 40 100 true\n"};
+    const std::string late {"3 1000 2000 true\n1 100 150 false\n9 0 10 true\n"};
+    const auto path = std::filesystem::temp_directory_path() / "electra2_follow_test.txt";
+    const auto allPath = std::filesystem::temp_directory_path() / "electra2_follow_all_test.txt";
+    std::ofstream {allPath} << topology << early << "3 1000 2000 true\n1 100 150 false\n";
+    ChargingNetwork all {allPath};
+    std::filesystem::remove ( allPath );
+
+    std::ofstream {path} << topology << early << "3 1000"; //the writer is mid-line
+    DataFileFollower follower {path};
+    ASSERT_EQ( follower.getOffset(), topology.size() + early.size() );
+    ASSERT_FALSE( follower.poll() );
+
+    std::ofstream {path, std::ios::app} << late.substr ( 6 );
+    ASSERT_TRUE( follower.poll() );
+    ASSERT_EQ( follower.getOffset(), topology.size() + early.size() + late.size() );
+    ASSERT_TRUE( follower.getNetwork().getStationAvailabilityReport() == all.getStationAvailabilityReport() );
+    ASSERT_FALSE( follower.poll() );
+
+    std::ofstream {path} << topology << early; //truncated and rewritten, shorter
+    ASSERT_TRUE( follower.poll() );
+    ASSERT_EQ( follower.getOffset(), topology.size() + early.size() );
+    std::ofstream {allPath} << topology << early;
+    ASSERT_TRUE( follower.getNetwork().getStationAvailabilityReport() == ChargingNetwork {allPath}.getStationAvailabilityReport() );
+
+    //replaced by a longer file renamed over it, as a log rotation would: read from the start, not from the old offset
+    const std::string rotated {topology + "1 0 100 false\n2 0 100 false\n3 0 100 false\n3 100 2000 true\n"};
+    ASSERT_GT( rotated.size(), follower.getOffset() );
+    std::ofstream {allPath} << rotated;
+    const auto rotatedReport = ChargingNetwork {allPath}.getStationAvailabilityReport();
+    std::filesystem::rename ( allPath, path );
+    ASSERT_TRUE( follower.poll() );
+    ASSERT_EQ( follower.getOffset(), rotated.size() );
+    ASSERT_TRUE( follower.getNetwork().getStationAvailabilityReport() == rotatedReport );
+    ASSERT_FALSE( follower.poll() );
+    std::filesystem::remove ( path );
+}
+
+TEST ( ReportServer, QueryTest ) {
+    const auto path = std::filesystem::temp_directory_path() / "electra2_server_test.txt";
+    const auto socketPath = std::filesystem::temp_directory_path() / "electra2_server_test.sock";
+    std::ofstream {path} << "[Stations]\n0 1 2\n1 3\n\n[Charger Availability Reports]\n"
+                            "1 0 60 true\n2 40 100 false\n3 1000 2000 true\n";
+    ChargingNetwork cn {path};
+
+    ReportServer server {path, socketPath, 2};
+    std::jthread serving {[&server] { server.run(); }};
+    struct Stopper { ReportServer& server; ~Stopper() { server.stop(); } } stopper {server}; //before serving joins
+    {
+        ReportClient client {socketPath};
+        ReportClient other {socketPath}; //served at the same time
+        ASSERT_TRUE( client.getReport() == cn.getStationAvailabilityReport() );
+        ASSERT_EQ( other.getStationUptime ( 0 ), 0.6f );
+        ASSERT_EQ( client.getStationUptime ( 7 ), std::nullopt );
+        ASSERT_EQ( client.getChargerUptime ( 2 ), 0.0f );
+        ASSERT_EQ( client.getChargerUptime ( 9 ), std::nullopt );
+
+        std::ofstream {path} << "[Stations]\n0 1\n\n[Charger Availability Reports]\n1 0 60 true\n";
+        ASSERT_TRUE( other.reload() );
+        ASSERT_EQ( client.getStationUptime ( 0 ), 1.0f );
+        ASSERT_EQ( client.getStationUptime ( 1 ), std::nullopt );
+
+        std::filesystem::remove ( path );
+        ASSERT_FALSE( client.reload() ); //and keeps what it had
+        ASSERT_EQ( client.getStationUptime ( 0 ), 1.0f );
+    }
+}
+
+TEST ( ReportServer, SocketInUseTest ) {
+    const auto path = std::filesystem::temp_directory_path() / "electra2_socket_test.txt";
+    const auto socketPath = std::filesystem::temp_directory_path() / "electra2_socket_test.sock";
+    std::ofstream {path} << "[Stations]\n0 1\n\n[Charger Availability Reports]\n1 0 60 true\n";
+    {
+        ReportServer first {path, socketPath, 1};
+        ASSERT_THROW( ReportServer ( path, socketPath, 1 ), std::system_error ); //first is listening on it
+        ASSERT_TRUE( std::filesystem::is_socket ( socketPath ) ); //and keeps it
+    }
+    ASSERT_FALSE( std::filesystem::exists ( socketPath ) );
+
+    //a socket which nothing listens on any more is replaced
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+    socketPath.string().copy ( address.sun_path, sizeof address.sun_path - 1 );
+    const int stale = ::socket ( AF_UNIX, SOCK_STREAM, 0 );
+    ASSERT_EQ( ::bind ( stale, reinterpret_cast<const sockaddr*> ( &address ), sizeof address ), 0 );
+    ::close ( stale );
+    ASSERT_TRUE( std::filesystem::is_socket ( socketPath ) );
+    {
+        ReportServer second {path, socketPath, 1};
+    }
+    ASSERT_FALSE( std::filesystem::exists ( socketPath ) );
+    std::filesystem::remove ( path );
+}
+
+TEST ( ReportServer, IdleConnectionsTest ) {
+    const auto path = std::filesystem::temp_directory_path() / "electra2_idle_test.txt";
+    const auto socketPath = std::filesystem::temp_directory_path() / "electra2_idle_test.sock";
+    std::ofstream {path} << "[Stations]\n0 1\n\n[Charger Availability Reports]\n1 0 60 true\n";
+    ReportServer server {path, socketPath, 2};
+    std::jthread serving {[&server] { server.run(); }};
+    struct Stopper { ReportServer& server; ~Stopper() { server.stop(); } } stopper {server}; //before serving joins
+
+    //more clients than workers which connect and send nothing, and one which stalls mid-request
+    std::vector<ReportClient> idle;
+    for ( int i = 0; i < 4; ++i )
+        idle.emplace_back ( socketPath );
+    const int partial = ::socket ( AF_UNIX, SOCK_STREAM, 0 );
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+    socketPath.string().copy ( address.sun_path, sizeof address.sun_path - 1 );
+    ASSERT_EQ( ::connect ( partial, reinterpret_cast<const sockaddr*> ( &address ), sizeof address ), 0 );
+    ASSERT_EQ( ::write ( partial, "\x05\0", 2 ), 2 ); //half a length prefix
+
+    auto query = std::async ( std::launch::async, [&socketPath] { return ReportClient {socketPath}.getStationUptime ( 0 ); } );
+    const bool answered = ( query.wait_for ( std::chrono::seconds {5} ) == std::future_status::ready );
+    if ( not answered )
+        server.stop(); //which closes the query's connection, rather than the test hang on it
+    ASSERT_TRUE( answered );
+    ASSERT_EQ( query.get(), 1.0f );
+    //an idle connection is served when it does send, and again after that
+    ASSERT_EQ( idle[3].getStationUptime ( 0 ), 1.0f );
+    ASSERT_EQ( idle[3].getStationUptime ( 0 ), 1.0f );
+    ::close ( partial );
+    std::filesystem::remove ( path );
+}
+
+TEST ( DenseIdMap, FindTest ) {
+    //compact IDs get a flat table, spread out ones a hash table; both must agree
+    for ( const uint32_t stride : {1u, 7919u} ) {
+        std::vector<uint32_t> ids;
+        for ( uint32_t i = 0; i < 1000; ++i )
+            ids.push_back ( 1000 + ( i * 37 % 1000 ) * stride );
+        ids.push_back ( ids[5] ); //listed twice: the first index wins
+        const DenseIdMap index {ids};
+        ASSERT_EQ( index.size(), 1000u );
+        for ( uint32_t i = 0; i < 1000; ++i )
+            ASSERT_EQ( index.find ( ids[i] ), i );
+        ASSERT_EQ( index.find ( 999 ), DenseIdMap::NOT_FOUND );
+        ASSERT_EQ( index.find ( 1000 + 1000 * stride ), DenseIdMap::NOT_FOUND );
+        ASSERT_EQ( index.find ( UINT32_MAX ), DenseIdMap::NOT_FOUND );
+    }
+    ASSERT_EQ( DenseIdMap().find ( 0 ), DenseIdMap::NOT_FOUND );
+}
+
+TEST ( NetworkArena, OutlivesNetworkTest ) {
+    shared_ptr<Charger> charger;
+    {
+        NetworkArena arena;
+        charger = arena.makeShared<Charger> ( 1001, arena.resource() );
+        charger->insertAvailabilityEvent ( 0, 50, true );
+    } //the Charger keeps the arena alive
+    charger->insertAvailabilityEvent ( 50, 100, false );
+    ASSERT_EQ( charger->getAvailabilityEvents().size(), 2u );
+
+    //a copy of a network shares its Chargers, and so their arena
+    auto original = std::make_unique<ChargingNetwork> ( "../data/input_1.txt" );
+    const ChargingNetwork copy {*original};
+    const auto expected = original->getStationAvailabilityReport();
+    original.reset();
+    ASSERT_TRUE( copy.getStationAvailabilityReport() == expected );
+}
+
+TEST ( ChargingNetwork, ViewTest ) {
+    const ChargingNetwork cn {"../data/input_1.txt"};
+    std::size_t chargerCount {0}, eventCount {0};
+    for ( const auto& [stationID, station] : cn.getStations() ) {
+        for ( const auto& charger : station->getChargers() ) {
+            //a view of the Charger's own events, not a copy of them
+            ASSERT_EQ( &charger->getAvailabilityEvents(), &charger->getAvailabilityEvents() );
+            ++chargerCount;
+            eventCount += charger->getAvailabilityEvents().size();
+        }
+    }
+    ASSERT_EQ( chargerCount, cn.getChargers().size() );
+    ASSERT_GT( eventCount, 0u );
+
+    //the factory borrows the Stations
+    StationAvailabilityReportFactory factory {cn.getStations()};
+    ASSERT_TRUE( factory.getReport() == cn.getStationAvailabilityReport() );
+    ASSERT_TRUE( StationAvailabilityReportFactory().getReport() == StationAvailabilityReport() );
+}
+
+TEST ( AvailabilityEventStore, CoalesceTest ) {
+    AvailabilityEventStore store;
+    ASSERT_TRUE( store.pushBackCoalesced ( 0, 100, true ) );
+    ASSERT_FALSE( store.pushBackCoalesced ( 100, 200, true ) );  //touches: widened to [0, 200)
+    ASSERT_FALSE( store.pushBackCoalesced ( 150, 180, true ) );  //inside
+    ASSERT_TRUE( store.pushBackCoalesced ( 200, 300, false ) );  //other flag
+    ASSERT_TRUE( store.pushBackCoalesced ( 350, 400, true ) );   //gap
+    ASSERT_FALSE( store.pushBackCoalesced ( 200, 300, false ) ); //retransmit
+    ASSERT_FALSE( store.pushBackCoalesced ( 50, 150, true ) );   //retransmit of a widened event
+    ASSERT_EQ( store.size(), 3u );
+    ASSERT_TRUE( store[0] == AvailabilityEvent( 0, 200, true ) );
+}
+
+TEST ( ChargingNetwork, CoalescingTest ) {
+    //runs of back-to-back reports with the same availability, and retransmitted pairs of lines
+    const auto path = std::filesystem::temp_directory_path() / "electra2_coalescing_test.txt";
+    {
+        std::ofstream ofs {path};
+        ofs << "[Stations]\n0 1000 1001\n1 1002\n\n[Charger Availability Reports]\n";
+        for ( uint64_t i = 0; i < 150000; i++ ) {
+            const uint64_t charger = i % 3, start = ( i / 3 ) * 100;
+            const bool available = ( i / 3 / ( 5 + charger ) ) % 2 == 0;
+            ofs << 1000 + charger << " " << start << " " << start + 100 << " " << ( available ? "true" : "false" ) << "\n";
+            if ( i % 60 == 59 )
+                ofs << 1000 + charger << " " << start - 300 << " " << start - 200 << " " << ( available ? "true" : "false" ) << "\n";
+        }
+    }
+    auto eventCount = [] ( const ChargingNetwork& cn ) {
+        std::size_t count {0};
+        for ( const auto& [chargerID, charger] : cn.getChargers() )
+            count += charger->getAvailabilityEvents().size();
+        return count;
+    };
+    const ChargingNetwork plain {path};
+    using Engine = ChargingNetwork::IngestionEngine;
+    for ( const auto& [engine, threads] : {std::pair {Engine::MAPPED, 1u}, {Engine::STREAM, 1u}, {Engine::PARALLEL, 3u}} ) {
+        const ChargingNetwork coalesced {path, engine, threads, ChargingNetwork::EventCoalescing::MERGE};
+        ASSERT_LT( eventCount ( coalesced ) * 5, eventCount ( plain ) );
+        ASSERT_TRUE( coalesced.getStationAvailabilityReport() == plain.getStationAvailabilityReport() );
+        ASSERT_TRUE( coalesced.getStationAvailabilityReport ( 12345, 987654 ) == plain.getStationAvailabilityReport ( 12345, 987654 ) );
+        ASSERT_EQ( coalesced.getChargerUptime ( 1001 ), plain.getChargerUptime ( 1001 ) );
+    }
+    std::filesystem::remove ( path );
+
+    const ChargingNetwork input4 {"../data/input_4.txt", Engine::MAPPED, 1, ChargingNetwork::EventCoalescing::MERGE};
+    ASSERT_EQ( input4.getChargers().at ( 1002 )->getAvailabilityEvents().size(), 3u ); //the retransmitted pair is dropped
+    ASSERT_TRUE( input4.getStationAvailabilityReport() == ChargingNetwork {"../data/input_4.txt"}.getStationAvailabilityReport() );
+}
+
+TEST ( OptionParsing, ParseUnsignedTest ) {
+    ASSERT_EQ( parseUnsigned ( "0" ), 0u );
+    ASSERT_EQ( parseUnsigned ( "4294967295", UINT32_MAX ), UINT32_MAX );
+    ASSERT_EQ( parseUnsigned ( "18446744073709551615" ), UINT64_MAX );
+    //what electra2_generate --stations, --chargers and --events used to wrap or narrow
+    ASSERT_THROW( parseUnsigned ( "-1", UINT32_MAX ), std::out_of_range );
+    ASSERT_THROW( parseUnsigned ( "4294967298", UINT32_MAX ), std::out_of_range );
+    ASSERT_THROW( parseUnsigned ( "4294967297", UINT32_MAX ), std::out_of_range );
+    ASSERT_THROW( parseUnsigned ( "18446744073709551616" ), std::out_of_range );
+    ASSERT_THROW( parseUnsigned ( "4x" ), std::invalid_argument );
+    ASSERT_THROW( parseUnsigned ( "" ), std::invalid_argument );
+    ASSERT_THROW( parseUnsigned ( " -3" ), std::invalid_argument ); //stoull would skip the space and wrap
+}
+
+TEST ( SyntheticNetworkGenerator, ParseCountTest ) {
+    ASSERT_EQ( SyntheticNetworkGenerator::parseCount ( "512" ), 512u );
+    ASSERT_EQ( SyntheticNetworkGenerator::parseCount ( "16K" ), 16000u );
+    ASSERT_EQ( SyntheticNetworkGenerator::parseCount ( "1.5m" ), 1500000u );
+    ASSERT_EQ( SyntheticNetworkGenerator::parseCount ( "1G" ), 1000000000u );
+    ASSERT_THROW( SyntheticNetworkGenerator::parseCount ( "16Kx" ), std::invalid_argument );
+    ASSERT_THROW( SyntheticNetworkGenerator::parseCount ( "16T" ), std::invalid_argument );
+    ASSERT_THROW( SyntheticNetworkGenerator::parseCount ( "K" ), std::invalid_argument );
+    ASSERT_THROW( SyntheticNetworkGenerator::parseCount ( "0" ), std::out_of_range );
+    ASSERT_THROW( SyntheticNetworkGenerator::parseCount ( "-5" ), std::out_of_range );
+    ASSERT_THROW( SyntheticNetworkGenerator::parseCount ( "nan" ), std::out_of_range );
+}
+
+TEST ( SyntheticNetworkGenerator, DeterministicTest ) {
+    SyntheticNetworkGenerator::Options options;
+    options.seed = 42;
+    options.stationCount = 200;
+    options.distribution = SyntheticNetworkGenerator::ChargerDistribution::SKEWED;
+    options.eventsPerCharger = 30;
+    options.duplicateRate = 0.2;
+    options.sortedness = 0.5;
+    options.whitespace = SyntheticNetworkGenerator::Whitespace::MIXED;
+    std::ostringstream first, second, otherSeed;
+    SyntheticNetworkGenerator {options}.write ( first );
+    SyntheticNetworkGenerator {options}.write ( second );
+    options.seed = 43;
+    SyntheticNetworkGenerator {options}.write ( otherSeed );
+    ASSERT_EQ( first.str(), second.str() );
+    ASSERT_NE( first.str(), otherSeed.str() );
+
+    const auto path = std::filesystem::temp_directory_path() / "electra2_generator_test.txt";
+    std::ofstream {path} << first.str();
+    const ChargingNetwork cn {path};
+    ASSERT_EQ( cn.getStations().size(), 200u );
+    ASSERT_EQ( cn.getChargers().size(), 506u ); //the same on every platform; no libm in the draw
+    std::size_t eventCount {0};
+    for ( const auto& [chargerID, charger] : cn.getChargers() )
+        eventCount += charger->getAvailabilityEvents().size();
+    ASSERT_GT( eventCount, cn.getChargers().size() * 30 ); //and some duplicates
+    StreamingUptimeEngine engine;
+    ASSERT_TRUE( engine.run ( path ) == cn.getStationAvailabilityReport() );
+    std::filesystem::remove ( path );
+}
+
+TEST ( UptimeSeriesReport, BucketTest ) {
+    //Station 0: available [0, 100) and [150, 200), down [100, 150). Station 1: [1000, 2000).
+    const auto path = std::filesystem::temp_directory_path() / "electra2_buckets_test.txt";
+    std::ofstream {path} << "[Stations]\n0 1 2\n1 3\n\n[Charger Availability Reports]\n"
+                            "1 0 60 true\n2 40 100 true\n1 100 150 false\n2 150 200 true\n3 1000 2000 true\n";
+    ChargingNetwork cn {path};
+    std::filesystem::remove ( path );
+
+    for ( const unsigned threads : {1u, 2u} ) {
+        const UptimeSeriesReport report = cn.getUptimeSeriesReport ( 64, threads );
+        ASSERT_EQ( report.getSeries().size(), 2u );
+        const auto& station0 = report.getSeries()[0];
+        ASSERT_EQ( station0.firstBucketStart, 0u );
+        ASSERT_EQ( station0.availableTime, ( vector<nanoseconds_t> {64, 36, 42, 8} ) );
+        ASSERT_EQ( station0.reportingTime, ( vector<nanoseconds_t> {64, 64, 64, 8} ) );
+        const auto& station1 = report.getSeries()[1];
+        ASSERT_EQ( station1.firstBucketStart, 960u );   //aligned to the bucket width
+        ASSERT_EQ( station1.availableTime.size(), 17u );
+        ASSERT_EQ( station1.availableTime.front(), 24u );
+        ASSERT_EQ( std::accumulate ( station1.availableTime.begin(), station1.availableTime.end(), nanoseconds_t {0} ), 1000u );
+        ASSERT_TRUE( station1.availableTime == station1.reportingTime );
+    }
+    ASSERT_EQ( StationUptimeSeries::bucketCount ( 1000, 2000, 64 ), 17u );
+    ASSERT_EQ( StationUptimeSeries::bucketCount ( UINT64_MAX, 0, 64 ), 0u );
+
+    //a width far below the data's span is refused, not allocated
+    std::ofstream {path} << "[Stations]\n0 1\n\n[Charger Availability Reports]\n1 0 1099511627776 true\n";
+    ChargingNetwork wide {path};
+    std::filesystem::remove ( path );
+    for ( const unsigned threads : {1u, 2u} )
+        ASSERT_THROW( wide.getUptimeSeriesReport ( 1, threads ), std::length_error );
+    ASSERT_EQ( wide.getUptimeSeriesReport ( 1u << 24 ).getSeries()[0].availableTime.size(), 65536u );
+}
+
+TEST ( DataFileParser, AvailabilityLineTest ) {
+    DataFileParser::AvailabilityRecord record;
+    ASSERT_TRUE( DataFileParser::parseAvailabilityLine( "1001\t50000 100000  true\r", record ) );
+    ASSERT_EQ( record.chargerID, 1001u );
+    ASSERT_EQ( record.startTime, 50000u );
+    ASSERT_EQ( record.endTime, 100000u );
+    ASSERT_TRUE( record.available );
+    ASSERT_TRUE( DataFileParser::parseAvailabilityLine( "1001 0 1 truest", record ) );
+    ASSERT_FALSE( record.available );
+    ASSERT_FALSE( DataFileParser::parseAvailabilityLine( "1001 abc 1 true", record ) );
+}
+
+TEST ( NetworkSnapshot, RoundTripTest ) {
+    const auto snapshot = std::filesystem::temp_directory_path() / "electra2_snapshot_test.snap";
+    for ( const string inputFile : {"../data/input_1.txt", "../data/input_2.txt", "../data/input_3.txt",
+                                    "../data/input_4.txt", "../data/input_5.txt", "../data/random_binary_file"} ) {
+        ChargingNetwork cn {inputFile};
+        NetworkSnapshot::save ( cn, snapshot );
+        ChargingNetwork loaded = NetworkSnapshot::load ( snapshot );
+        ASSERT_TRUE( loaded.getStationAvailabilityReport() == cn.getStationAvailabilityReport() ) << inputFile;
+    }
+    std::filesystem::remove ( snapshot );
+}
+
+TEST ( NetworkSnapshot, CorruptTest ) {
+    const auto snapshot = std::filesystem::temp_directory_path() / "electra2_snapshot_corrupt.snap";
+    NetworkSnapshot::save ( ChargingNetwork {"../data/input_1.txt"}, snapshot );
+    {
+        std::fstream fs {snapshot, std::ios::binary | std::ios::in | std::ios::out};
+        fs.seekp ( -1, std::ios::end );
+        fs.put ( '\x7f' );
+    }
+    ASSERT_THROW( NetworkSnapshot::load ( snapshot ), std::runtime_error );
+    ASSERT_NO_THROW( NetworkSnapshot::load ( snapshot, NetworkSnapshot::Verification::STRUCTURE ) );
+    std::filesystem::resize_file ( snapshot, std::filesystem::file_size ( snapshot ) - 8 );
+    ASSERT_THROW( NetworkSnapshot::load ( snapshot, NetworkSnapshot::Verification::STRUCTURE ), std::runtime_error );
+    std::filesystem::remove ( snapshot );
+}
+
+TEST ( AvailabilityEventStore, BorrowTest ) {
+    const vector<nanoseconds_t> starts {0, 10, 20}, ends {5, 15, 25};
+    const vector<uint64_t> bits {0b101};
+    auto backing = std::make_shared<int> ( 0 );
+    auto borrowed = AvailabilityEventStore::borrow ( starts, ends, bits, backing );
+    ASSERT_TRUE( borrowed.isBorrowed() );
+    ASSERT_TRUE( borrowed[2] == AvailabilityEvent( 20, 25, true ) );
+    auto copy = borrowed;
+    copy.push_back ( 30, 35, false );   //copy-on-write
+    ASSERT_FALSE( copy.isBorrowed() );
+    ASSERT_EQ( copy.size(), 4u );
+    ASSERT_EQ( borrowed.size(), 3u );
+    ASSERT_EQ( backing.use_count(), 2 );
+}
+
 } //namespace Charging
 
@@ -0,0 +1,307 @@
+// Run the whole pipeline over a grid of generated data files, recording time and memory against input size and shape.
+// SPDX-FileCopyrightText: 2025 Jaspreet Dha git@jsvi.org
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+using std::string;
+#include <vector>
+using std::vector;
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <filesystem>
+#include <streambuf>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "Benchmarking.h"
+#include "ChargingNetwork.h"
+#include "OptionParsing.h"
+#include "ParallelFor.h"
+#include "ReportWriter.h"
+#include "StationAvailabilityReportFactory.h"
+#include "SyntheticNetworkGenerator.h"
+
+using namespace Charging;
+
+namespace {
+
+using UptimeEngine = StationAvailabilityReportFactory::UptimeEngine;
+
+/**
+ * @brief One point of the grid: the shape of the data file, and how it's reported on.
+ */
+struct Configuration {
+    std::size_t events {0};         ///< asked for; the file has about this many
+    uint32_t chargersPerStation {1};
+    uint32_t eventsPerCharger {100};
+    double overlap {0};
+    UptimeEngine engine {UptimeEngine::KWAY_MERGE};
+};
+
+/**
+ * @brief What the child running one Configuration reports back thru the pipe.
+ */
+struct Measurement {
+    double wallSeconds {0};
+    std::size_t events {0};     ///< events kept by the network
+    std::size_t stations {0};
+};
+
+/**
+ * @brief Throws away whatever is written to it. The report is formatted, but not written anywhere.
+ */
+class NullBuffer : public std::streambuf
+{
+protected:
+    std::streamsize xsputn ( const char*, std::streamsize n ) override { return n; }
+    int_type overflow ( int_type c ) override { return traits_type::not_eof ( c ); }
+};
+
+/**
+ * @brief Parse a comma separated list, each item with parse().
+ */
+template<typename Parse>
+auto parseList ( const string& text, Parse parse ) {
+    vector<decltype ( parse ( string {} ) )> items;
+    std::istringstream list {text};
+    for ( string item; std::getline ( list, item, ',' ); )
+        items.push_back ( parse ( item ) );
+    if ( items.empty() )
+        throw std::invalid_argument ( text );
+    return items;
+}
+
+/**
+ * @brief Generate the data file of a Configuration: Stations of exactly chargersPerStation
+ * Chargers, eventsPerCharger reports each, in time order, without duplicates.
+ */
+void generate ( const std::filesystem::path& path, const Configuration& configuration, uint64_t seed ) {
+    SyntheticNetworkGenerator::Options options;
+    options.seed = seed;
+    options.distribution = SyntheticNetworkGenerator::ChargerDistribution::FIXED;
+    options.chargersPerStation = configuration.chargersPerStation;
+    options.eventsPerCharger = configuration.eventsPerCharger;
+    options.overlapRate = configuration.overlap;
+    options.duplicateRate = 0;
+    options.sortedness = 1;
+    const double eventsPerStation = static_cast<double> ( configuration.chargersPerStation ) * configuration.eventsPerCharger;
+    options.stationCount = static_cast<uint32_t> ( std::max ( 1.0, std::round ( configuration.events / eventsPerStation ) ) );
+    std::ofstream ofs {path, std::ios::binary};
+    SyntheticNetworkGenerator {options}.write ( ofs );
+}
+
+/**
+ * @brief What main does for a data file: read it, make the report, write it.
+ */
+Measurement runPipeline ( const std::filesystem::path& path, UptimeEngine engine, unsigned threadCount ) {
+    Measurement measurement;
+    measurement.wallSeconds = timeOnce ( [&] () {
+        const ChargingNetwork network {path, threadCount > 1 ? ChargingNetwork::IngestionEngine::PARALLEL
+                                                             : ChargingNetwork::IngestionEngine::MAPPED, threadCount};
+        StationAvailabilityReportFactory factory {network.getStations(), threadCount, engine};
+        NullBuffer nullBuffer;
+        std::ostream null {&nullBuffer};
+        Availability::ReportWriter ( null ).write ( factory.getReport() );
+        measurement.events = network.getEventCount();
+        measurement.stations = network.getStations().size();
+    } );
+    return measurement;
+}
+
+/**
+ * @brief Run the pipeline in a child process, so that its peak RSS and CPU time are its own,
+ * and write a row of CSV.
+ * The child is forked, not exec'ed: it runs the same code, in this process image, on the data
+ * file that's already been generated. Its peak RSS counts the little it inherits from here.
+ *
+ * @return false if the child failed, e.g. ran out of memory
+ */
+bool measure ( const Configuration& configuration, const std::filesystem::path& path, unsigned threadCount, std::ostream& csv ) {
+    int pipeEnds[2];
+    if ( pipe ( pipeEnds ) != 0 )
+        throw std::system_error ( errno, std::generic_category(), "pipe" );
+    std::cout.flush();
+    const pid_t child = fork();
+    if ( child < 0 )
+        throw std::system_error ( errno, std::generic_category(), "fork" );
+    if ( child == 0 ) {
+        close ( pipeEnds[0] );
+        int status {EXIT_SUCCESS};
+        try {
+            const Measurement measurement = runPipeline ( path, configuration.engine, threadCount );
+            if ( write ( pipeEnds[1], &measurement, sizeof measurement ) != sizeof measurement )
+                status = EXIT_FAILURE;
+        } catch ( const std::exception& ex ) {
+            std::cerr << ex.what() << "\n";
+            status = EXIT_FAILURE;
+        }
+        _exit ( status ); //no destructors or atexit handlers of the parent's
+    }
+
+    close ( pipeEnds[1] );
+    Measurement measurement;
+    const bool received = ( read ( pipeEnds[0], &measurement, sizeof measurement ) == sizeof measurement );
+    close ( pipeEnds[0] );
+    int status {0};
+    rusage usage {};
+    wait4 ( child, &status, 0, &usage );
+    if ( not received or not WIFEXITED ( status ) or WEXITSTATUS ( status ) != EXIT_SUCCESS ) {
+        std::cerr << "Failed: " << configuration.events << " events, " << configuration.chargersPerStation
+                  << " chargers per station, overlap " << configuration.overlap
+                  << ( WIFSIGNALED ( status ) ? ", killed by signal " + std::to_string ( WTERMSIG ( status ) ) : string {} ) << "\n";
+        return false;
+    }
+
+    auto seconds = [] ( const timeval& tv ) { return tv.tv_sec + tv.tv_usec / 1e6; };
+    const double cpuSeconds = seconds ( usage.ru_utime ) + seconds ( usage.ru_stime );
+    csv << measurement.events << "," << measurement.stations << "," << configuration.chargersPerStation << ","
+        << configuration.eventsPerCharger << "," << configuration.overlap << ","
+        << ( configuration.engine == UptimeEngine::KWAY_MERGE ? "kway" : "consolidate" ) << "," << threadCount << ","
+        << std::filesystem::file_size ( path ) << "," << measurement.wallSeconds << "," << cpuSeconds << ","
+        << usage.ru_maxrss << "," << measurement.events / measurement.wallSeconds << ","
+        << measurement.wallSeconds * 1e9 / std::max<std::size_t> ( measurement.events, 1 ) << "\n";
+    csv.flush(); //a row at a time, so a long sweep shows its progress
+    return true;
+}
+
+} //namespace
+
+/**
+ * @brief Entry point for electra2_sweep.
+ * For every combination of the lists given, generates a data file of that size and shape, runs
+ * what main runs over it (ChargingNetwork, the report, writing it) in a child process, and
+ * writes a row of CSV:
+ *
+ *      events,stations,chargers_per_station,events_per_charger,overlap,engine,threads,input_bytes,
+ *      wall_seconds,cpu_seconds,peak_rss_kib,events_per_second,ns_per_event
+ *
+ * ns_per_event should stay flat as events grow. Where it climbs, something is superlinear: the
+ * consolidate engine's sort in removeOverlaps() as Stations get more events (more chargers per
+ * station, or events per charger), or the lookups of Stations and Chargers as there are more of
+ * them. Build with CMAKE_BUILD_TYPE=Release.
+ *
+ * Options:
+ *
+ *      --events LIST       Events in the data file, e.g. 10K,100K,1M (the default).
+ *      --fanout LIST       Chargers per station. Default 1,8,64.
+ *      --per-charger LIST  Availability reports per charger. Default 100.
+ *      --overlap LIST      Chance, 0 to 1, that a report overlaps the charger's previous one.
+ *                          Default 0,0.5,0.9.
+ *      --engine LIST       kway, consolidate or both (the default). See UptimeEngine.
+ *      --threads N         Threads to parse and report on. Default 1.
+ *      --seed N            Seed for the generated data files.
+ *      --output FILE       Write the CSV to FILE instead of stdout.
+ *
+ * @param argc The number of arguments passed on the command line
+ * @param argv The arguments
+ * @return int
+ */
+int main(int argc, char **argv) {
+
+    auto usageError = [argv] (const string& explanation) {
+        std::cerr << explanation << "\n";
+        std::cerr << "Usage: " << argv[0] << " [--events 10K,100K,1M] [--fanout 1,8,64] [--per-charger 100] [--overlap 0,0.5,0.9]"
+                     " [--engine kway,consolidate] [--threads N] [--seed N] [--output FILE]\n";
+        return EXIT_FAILURE;
+    };
+
+    vector<std::size_t> eventCounts {10'000, 100'000, 1'000'000};
+    vector<uint32_t> fanouts {1, 8, 64};
+    vector<uint32_t> perCharger {100};
+    vector<double> overlaps {0, 0.5, 0.9};
+    vector<UptimeEngine> engines {UptimeEngine::KWAY_MERGE, UptimeEngine::CONSOLIDATE_SORT};
+    unsigned threadCount {1};
+    uint64_t seed {1};
+    string outputFile;
+    for (int arg = 1; arg < argc; ++arg) {
+        const string option {argv[arg]};
+        if (arg + 1 >= argc) {
+            return usageError("Missing value for " + option);
+        }
+        const string value {argv[++arg]};
+        auto positive = [] (const string& item) {
+            const auto count = std::stoul(item);
+            if (count == 0 or count > UINT32_MAX)
+                throw std::out_of_range(item);
+            return static_cast<uint32_t>(count);
+        };
+        try {
+            if (option == "--events") {
+                eventCounts = parseList(value, SyntheticNetworkGenerator::parseCount);
+            } else if (option == "--fanout") {
+                fanouts = parseList(value, positive);
+            } else if (option == "--per-charger") {
+                perCharger = parseList(value, positive);
+            } else if (option == "--overlap") {
+                overlaps = parseList(value, [] (const string& item) {
+                    const double p = std::stod(item);
+                    if (p < 0.0 or p > 1.0)
+                        throw std::out_of_range(item);
+                    return p;
+                });
+            } else if (option == "--engine") {
+                engines = parseList(value, [] (const string& item) {
+                    if (item == "kway")
+                        return UptimeEngine::KWAY_MERGE;
+                    if (item == "consolidate")
+                        return UptimeEngine::CONSOLIDATE_SORT;
+                    throw std::invalid_argument(item);
+                });
+            } else if (option == "--threads") {
+                threadCount = resolveThreadCount(parseUnsigned(value, UINT_MAX));
+            } else if (option == "--seed") {
+                seed = parseUnsigned(value);
+            } else if (option == "--output") {
+                outputFile = value;
+            } else {
+                return usageError("Unknown option: " + option);
+            }
+        } catch (const std::logic_error&) { //std::invalid_argument and std::out_of_range
+            return usageError("Invalid value for " + option + ": " + value);
+        }
+    }
+
+    std::ofstream ofs;
+    if (!outputFile.empty()) {
+        ofs.open(outputFile);
+        if (!ofs) {
+            std::cerr << "Could not open " << outputFile << "\n";
+            return EXIT_FAILURE;
+        }
+    }
+    std::ostream& csv = outputFile.empty() ? std::cout : ofs;
+    csv << "events,stations,chargers_per_station,events_per_charger,overlap,engine,threads,input_bytes,"
+           "wall_seconds,cpu_seconds,peak_rss_kib,events_per_second,ns_per_event\n";
+
+    int returnCode = EXIT_SUCCESS;
+    const auto path = std::filesystem::temp_directory_path() / ("electra2_sweep_" + std::to_string(getpid()) + ".txt");
+    try {
+        //Each data file is generated once, and reported on by every engine
+        for (const std::size_t events : eventCounts) {
+            for (const uint32_t fanout : fanouts) {
+                for (const uint32_t eventsPerCharger : perCharger) {
+                    for (const double overlap : overlaps) {
+                        Configuration configuration {events, fanout, eventsPerCharger, overlap};
+                        generate(path, configuration, seed);
+                        for (const UptimeEngine engine : engines) {
+                            configuration.engine = engine;
+                            if (!measure(configuration, path, threadCount, csv))
+                                returnCode = EXIT_FAILURE;
+                        }
+                    }
+                }
+            }
+        }
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << "\n";
+        returnCode = EXIT_FAILURE;
+    }
+    std::filesystem::remove(path);
+    return returnCode;
+}